@@ -1,7 +1,8 @@
 #include "CameraCapture.h"
 
 //==============================================================================
-CameraCapture::CameraCapture(MidiManager* midiManager) : mmRef(midiManager)
+CameraCapture::CameraCapture(MidiManager* midiManager)
+    : juce::Thread("Camera processing"), mmRef(midiManager)
 {
     auto devices = juce::CameraDevice::getAvailableDevices();
     for (auto& d : devices) {
@@ -16,14 +17,34 @@ CameraCapture::CameraCapture(MidiManager* midiManager) : mmRef(midiManager)
     
     takePhotoButton.setVisible(false);
     
+    // Avancement et fin d'impression, reçus sur le thread message
+    printSpooler.onProgress = [this](int, float progress)
+    {
+        printProgress = progress;
+        repaint(getPrintProgressBounds());
+    };
+    
+    printSpooler.onJobFinished = [this](int, bool)
+    {
+        printProgress = printSpooler.isPrinting() ? 0.f : -1.f;
+        repaint();
+        
+        if (onPrintFinished)
+            onPrintFinished();
+    };
+    
     setSize(640, 480);
+    
+    startThread(juce::Thread::Priority::high);
 }
 
 CameraCapture::~CameraCapture()
 {
     stopTimer();
-    if (camera)
-        camera->removeListener(this);
+    frameSource.reset();
+    
+    stopThread(2000);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -31,67 +52,391 @@ void CameraCapture::resized()
 {
     takePhotoButton.setBounds(10, 10, 120, 30);
     
-    if (!camera) {
-        camera.reset(juce::CameraDevice::openDevice(0));
-        
-        if (camera)
-            camera->addListener(this);
-    }
+    // Ouvrir la première caméra si aucune autre source n'a été choisie
+    if (!frameSource)
+        setFrameSource(std::make_unique<CameraFrameSource>(0));
+}
 
+void CameraCapture::setFrameSource(std::unique_ptr<FrameSource> newSource)
+{
+    frameSource.reset();
+    
+    if (newSource == nullptr)
+        return;
+    
+    newSource->onFrame = [this](const juce::Image& image) { imageReceived(image); };
+    
+    if (newSource->start())
+        juce::Logger::writeToLog("Frame source: " + newSource->getDescription());
+    else
+        juce::Logger::writeToLog("Failed to start frame source: " + newSource->getDescription());
+    
+    frameSource = std::move(newSource);
 }
 
 void CameraCapture::setThreshold(float value)
 {
     threshold = (int)(value * 255.f);
+    
+    // Re-rendu immédiat de l'aperçu depuis les sommes de la dernière frame
+    rerenderRequested = true;
+    notify();
+}
+
+void CameraCapture::setAutoThreshold(bool shouldBeAuto)
+{
+    autoThreshold = shouldBeAuto;
+    rerenderRequested = true;
+    notify();
+}
+
+float CameraCapture::getAutoThresholdValue() const
+{
+    return autoThresholdValue / 255.f;
+}
+
+void CameraCapture::setQuantizerMode(Quantizer::Mode mode)
+{
+    quantizerMode = (int)mode;
+    rerenderRequested = true;
+    notify();
+}
+
+juce::String CameraCapture::getPipelineStats() const
+{
+    return "Camera pipeline - dropped: " + juce::String(framesDropped.load())
+         + ", overwritten before display: " + juce::String(framesOverwritten.load())
+         + ", processed: " + juce::String(framesProcessed.load())
+         + ", displayed: " + juce::String(framesDisplayed.load())
+         + ", tiles recomputed/frame: "
+         + juce::String((double)tilesRecomputed.load() / juce::jmax(1u, framesProcessed.load()), 0);
+}
+
+juce::String CameraCapture::getLatencyReport() const
+{
+    return "Camera latency - " + juce::String(framesOverwritten.load()) + " of "
+         + juce::String(framesProcessed.load()) + " frame(s) never displayed (overwritten)"
+         + "\n  " + queueLatency.toString("receive -> process")
+         + "\n  " + quantizeLatency.toString("resample + quantize")
+         + "\n  " + displayLatency.toString("publish -> paint")
+         + "\n  " + paintLatency.toString("paint")
+         + "\n  " + endToEndLatency.toString("receive -> screen");
+}
+
+void CameraCapture::resetLatencyStats()
+{
+    queueLatency.reset();
+    quantizeLatency.reset();
+    displayLatency.reset();
+    paintLatency.reset();
+    endToEndLatency.reset();
 }
 
 //==============================================================================
 void CameraCapture::imageReceived(const juce::Image& image)
 {
-    auto now = juce::Time::getMillisecondCounter();
-    if (now - lastUpdateTime < 500) // 500 ms = 2 fps
-        return; // skip cette frame
+    auto receivedTicks = LatencyHistogram::now();
+    
+    // On ne fait que déposer la frame : le traitement se fait sur le thread dédié,
+    // et une frame encore en attente est remplacée par la plus récente
+    {
+        const juce::SpinLock::ScopedLockType sl(pendingLock);
+        if (pendingFrame.isValid())
+            ++framesDropped;
+        pendingFrame = image;
+        pendingFrameTicks = receivedTicks;
+    }
+    
+    notify();
+}
+
+void CameraCapture::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(-1);
+        
+        juce::Image frame;
+        juce::int64 receivedTicks = 0;
+        {
+            const juce::SpinLock::ScopedLockType sl(pendingLock);
+            std::swap(frame, pendingFrame);
+            std::swap(receivedTicks, pendingFrameTicks);
+        }
+        
+        bool rerender = rerenderRequested.exchange(false);
+        auto processStartTicks = LatencyHistogram::now();
+        
+        if (frame.isValid())
+        {
+            queueLatency.record(receivedTicks, processStartTicks);
+            
+            bool forceFull = ++framesSinceFullRefresh >= fullRefreshInterval;
+            if (forceFull)
+                framesSinceFullRefresh = 0;
+            
+            // Seules les tuiles qui ont bougé depuis la frame précédente sont recalculées
+            juce::Image::BitmapData src(frame, juce::Image::BitmapData::readOnly);
+            tilesRecomputed += (uint64_t)resampler.processChanged(src, frameSums, tileDirty, autoThreshold, forceFull);
+            ++framesProcessed;
+            
+            if (frameSums.hasHistogram)
+                updateAutoThreshold(frameSums);
+            else
+                smoothedThreshold = -1.f;
+        }
+        else if (!rerender || frameSums.tilesX == 0)
+        {
+            continue;
+        }
+        
+        auto& out = previewFrames.getWriteBuffer();
+        
+        // Rien à publier si aucune tuile n'a changé d'encre
+        if (!renderPreview(out, rerender))
+            continue;
+        
+        out.receivedTicks = frame.isValid() ? receivedTicks : 0;
+        out.processStartTicks = processStartTicks;
+        out.quantizedTicks = LatencyHistogram::now();
+        quantizeLatency.record(out.processStartTicks, out.quantizedTicks);
+        
+        auto dirtyTiles = out.dirtyTiles;
+        out.publishedTicks = LatencyHistogram::now();
+        
+        // La frame précédente n'a jamais été affichée : elle est remplacée
+        if (! previewFrames.publish())
+            ++framesOverwritten;
+        
+        {
+            const juce::SpinLock::ScopedLockType sl(repaintLock);
+            pendingRepaintTiles = pendingRepaintTiles.isEmpty() ? dirtyTiles
+                                                                : pendingRepaintTiles.getUnion(dirtyTiles);
+        }
+        
+        triggerAsyncUpdate();
+    }
+}
+
+void CameraCapture::handleAsyncUpdate()
+{
+    juce::Rectangle<int> tiles;
+    {
+        const juce::SpinLock::ScopedLockType sl(repaintLock);
+        std::swap(tiles, pendingRepaintTiles);
+    }
+    
+    if (tiles.isEmpty())
+        return;
+    
+    // Seule la zone de l'écran couverte par les tuiles modifiées est redessinée
+    auto scaleX = (float)getWidth() / (float)PrintBitmap::width;
+    auto scaleY = (float)getHeight() / (float)PrintBitmap::height;
+    
+    repaint(tiles.toFloat()
+                 .transformedBy(juce::AffineTransform::scale(scaleX, scaleY))
+                 .getSmallestIntegerContainer()
+                 .expanded(1));
+}
+
+void CameraCapture::updateAutoThreshold(const LumaKernel::TileSums& sums)
+{
+    // Otsu sur la frame, lissé dans le temps pour éviter le scintillement
+    float otsu = (float)LumaKernel::computeOtsuThreshold(sums.histogram);
+    
+    if (smoothedThreshold < 0.f)
+        smoothedThreshold = otsu;
+    else
+        smoothedThreshold += (otsu - smoothedThreshold) * autoThresholdSmoothing;
+    
+    autoThresholdValue = juce::roundToInt(smoothedThreshold);
+}
+
+bool CameraCapture::renderPreview(PreviewFrame& frame, bool requantizeAll)
+{
+    const auto& sums = frameSums;
+    const int numTiles = sums.tilesX * sums.tilesY;
+    bool fullFrame = publishedSequence == 0;
+    
+    if (activeQuantizerMode != quantizerMode)
+    {
+        activeQuantizerMode = quantizerMode;
+        quantizer = Quantizer::create((Quantizer::Mode)activeQuantizerMode);
+        requantizeAll = true;
+    }
+    
+    int activeThreshold = autoThreshold ? autoThresholdValue.load() : threshold.load();
+    if (activeThreshold != lastQuantizedThreshold)
+    {
+        lastQuantizedThreshold = activeThreshold;
+        requantizeAll = true;
+    }
+    
+    if (currentInk.size() != (size_t)numTiles)
+    {
+        tileGreys.assign((size_t)numTiles, 0);
+        currentInk.assign((size_t)numTiles, 0);
+        quantizedInk.assign((size_t)numTiles, 0);
+        requantizeAll = true;
+        fullFrame = true;
+    }
     
-    lastUpdateTime = now;
+    // Moyennes des tuiles recalculées, et rangées de tuiles à requantifier
+    int firstRow = 0, endRow = sums.tilesY;
     
-    // Image noir et blanc
-    juce::Image bwImage(juce::Image::RGB, image.getWidth(), image.getHeight(), false);
+    if (requantizeAll)
+    {
+        sums.getAverages(tileGreys.data());
+    }
+    else
+    {
+        firstRow = sums.tilesY;
+        endRow = 0;
+        
+        for (int ty = 0; ty < sums.tilesY; ++ty)
+        {
+            const auto* rowDirty = tileDirty.data() + ty * sums.tilesX;
+            bool rowChanged = false;
+            
+            for (int tx = 0; tx < sums.tilesX; ++tx)
+            {
+                if (rowDirty[tx] != 0)
+                {
+                    tileGreys[(size_t)(ty * sums.tilesX + tx)] = sums.getAverage(tx, ty);
+                    rowChanged = true;
+                }
+            }
+            
+            if (rowChanged)
+            {
+                firstRow = juce::jmin(firstRow, ty);
+                endRow = ty + 1;
+            }
+        }
+    }
     
-    juce::Image::BitmapData src(image, juce::Image::BitmapData::readOnly);
-    juce::Image::BitmapData dst(bwImage, juce::Image::BitmapData::writeOnly);
+    // Encre des lignes requantifiées, comparée à la frame précédente
+    juce::Rectangle<int> changed;
     
-    for (int by = 0; by < image.getHeight(); by += tileSize)
+    if (firstRow < endRow)
     {
-        for (int bx = 0; bx < image.getWidth(); bx += tileSize)
+        auto rows = quantizer->processRows(tileGreys.data(), sums.tilesX, sums.tilesY, firstRow, endRow,
+                                           activeThreshold, quantizedInk.data());
+        int minX = sums.tilesX, maxX = -1, minY = sums.tilesY, maxY = -1;
+        
+        for (int ty = rows.getStart(); ty < rows.getEnd(); ++ty)
         {
-            juce::Colour tileColour = processBlockToColour(src, bx, by, image.getWidth(), image.getHeight()) ? juce::Colours::black : juce::Colours::white;
+            const auto offset = (size_t)(ty * sums.tilesX);
+            const auto* previous = currentInk.data() + offset;
+            const auto* latest = quantizedInk.data() + offset;
+            
+            if (std::memcmp(previous, latest, (size_t)sums.tilesX) == 0)
+                continue;
             
-            // Remplissage du bloc
-            for (int y = by; y < by + tileSize && y < image.getHeight(); ++y)
+            for (int tx = 0; tx < sums.tilesX; ++tx)
             {
-                for (int x = bx; x < bx + tileSize && x < image.getWidth(); ++x)
+                if (previous[tx] != latest[tx])
                 {
-                    dst.setPixelColour(x, y, tileColour);
+                    minX = juce::jmin(minX, tx);
+                    maxX = juce::jmax(maxX, tx);
                 }
             }
+            
+            minY = juce::jmin(minY, ty);
+            maxY = ty;
+            std::memcpy(currentInk.data() + offset, latest, (size_t)sums.tilesX);
         }
+        
+        if (maxY >= 0)
+            changed = { minX, minY, maxX - minX + 1, maxY - minY + 1 };
     }
     
+    if (fullFrame)
+        changed = { 0, 0, sums.tilesX, sums.tilesY };
+    
+    if (changed.isEmpty())
+        return false;
+    
+    // Aperçu complet à la résolution des tuiles (1 = noir), dans le buffer préalloué du slot
+    frame.tilesX = sums.tilesX;
+    frame.tilesY = sums.tilesY;
+    frame.tiles.assign(currentInk.begin(), currentInk.end());
+    frame.dirtyTiles = changed;
+    frame.sequence = ++publishedSequence;
+    return true;
+}
+
+void CameraCapture::updateDisplayImage(const PreviewFrame& frame)
+{
+    // Image d'affichage à la taille des tuiles, réallouée seulement si la caméra change
+    bool fullUpdate = frame.sequence != displayedSequence + 1;
+    displayedSequence = frame.sequence;
+    
+    if (displayImage.getWidth() != frame.tilesX || displayImage.getHeight() != frame.tilesY)
     {
-        const juce::ScopedLock lock(imageLock);
-        currentFrame = bwImage;
+        displayImage = juce::Image(juce::Image::RGB, frame.tilesX, frame.tilesY, false);
+        fullUpdate = true;
     }
     
-    juce::MessageManager::callAsync([this]() { repaint(); });
+    // Seules les tuiles modifiées sont recopiées, sauf si une frame a été sautée
+    auto area = fullUpdate ? displayImage.getBounds() : frame.dirtyTiles.getIntersection(displayImage.getBounds());
+    
+    if (area.isEmpty())
+        return;
+    
+    juce::Image::BitmapData dst(displayImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                juce::Image::BitmapData::writeOnly);
+    
+    for (int y = 0; y < area.getHeight(); ++y)
+    {
+        auto* line = dst.getLinePointer(y);
+        auto* row = frame.tiles.data() + (area.getY() + y) * frame.tilesX + area.getX();
+        
+        for (int x = 0; x < area.getWidth(); ++x)
+            std::memset(line + x * dst.pixelStride, row[x] ? 0x00 : 0xFF, (size_t)dst.pixelStride);
+    }
 }
 
 void CameraCapture::paint(juce::Graphics& g)
 {
+    auto paintStartTicks = LatencyHistogram::now();
     g.fillAll(juce::Colours::black);
     
-    const juce::ScopedLock lock(imageLock);
-    if (currentFrame.isValid())
-        g.drawImage(currentFrame, getLocalBounds().toFloat());
+    // Récupère la dernière frame publiée sans bloquer le thread de traitement
+    const bool newFrame = previewFrames.acquire();
+    if (newFrame)
+    {
+        const auto& frame = previewFrames.getReadBuffer();
+        displayLatency.record(frame.publishedTicks, paintStartTicks);
+        updateDisplayImage(frame);
+        ++framesDisplayed;
+    }
+    
+    // Agrandissement au plus proche voisin des tuiles
+    if (displayImage.isValid())
+    {
+        g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+        g.drawImage(displayImage, getLocalBounds().toFloat());
+    }
+    
+    if (newFrame)
+    {
+        auto paintedTicks = LatencyHistogram::now();
+        paintLatency.record(paintStartTicks, paintedTicks);
+        endToEndLatency.record(previewFrames.getReadBuffer().receivedTicks, paintedTicks);
+    }
+    
+    // Barre d'avancement de l'impression
+    if (printProgress >= 0.f)
+    {
+        auto bar = getPrintProgressBounds().toFloat();
+        
+        g.setColour(juce::Colours::black.withAlpha(0.6f));
+        g.fillRoundedRectangle(bar, 4.0f);
+        g.setColour(juce::Colours::white);
+        g.fillRoundedRectangle(bar.withWidth(bar.getWidth() * juce::jlimit(0.f, 1.f, printProgress)), 4.0f);
+        g.drawRoundedRectangle(bar, 4.0f, 1.5f);
+    }
     
     // Afficher le décompte si actif
     if (countdownValue > 0)
@@ -122,33 +467,64 @@ void CameraCapture::paint(juce::Graphics& g)
     }
 }
 
-//==============================================================================
-bool CameraCapture::processBlockToColour(const juce::Image::BitmapData& src,
-                                         int blockX, int blockY,
-                                         int imageWidth, int imageHeight)
+juce::String CameraCapture::runPipelineBenchmark(TimedFrameSource& source, int numFrames)
 {
-    int sumGrey = 0;
-    int count = 0;
+    LumaKernel::TileResampler benchResampler(PrintBitmap::width, PrintBitmap::height);
+    LumaKernel::TileSums sums;
+    std::vector<uint8_t> greys, ink;
+    auto benchQuantizer = Quantizer::create(Quantizer::Mode::floydSteinberg);
+    PrintBitmap bitmap;
+    uint8_t band[PrintBitmap::bytesPerBand];
     
-    // Calcul de la moyenne du bloc
-    for (int y = blockY; y < blockY + tileSize && y < imageHeight; ++y)
+    double sourceMs = 0.0, resampleMs = 0.0, quantizeMs = 0.0, encodeMs = 0.0, worstMs = 0.0;
+    
+    for (int i = 0; i < numFrames; ++i)
     {
-        for (int x = blockX; x < blockX + tileSize && x < imageWidth; ++x)
+        auto t0 = juce::Time::getMillisecondCounterHiRes();
+        auto image = source.renderNextFrame();
+        if (!image.isValid())
+            return "Pipeline benchmark: no frame from " + source.getDescription();
+        
+        auto t1 = juce::Time::getMillisecondCounterHiRes();
         {
-            auto c = src.getPixelColour(x, y);
-            uint8_t grey = static_cast<uint8_t>(0.299f * c.getRed()
-                                                + 0.587f * c.getGreen()
-                                                + 0.114f * c.getBlue());
-            sumGrey += grey;
-            ++count;
+            juce::Image::BitmapData src(image, juce::Image::BitmapData::readOnly);
+            benchResampler.process(src, sums, true);
         }
+        
+        auto t2 = juce::Time::getMillisecondCounterHiRes();
+        greys.resize(sums.sums.size());
+        ink.resize(sums.sums.size());
+        sums.getAverages(greys.data());
+        benchQuantizer->process(greys.data(), sums.tilesX, sums.tilesY,
+                                LumaKernel::computeOtsuThreshold(sums.histogram), ink.data());
+        
+        auto t3 = juce::Time::getMillisecondCounterHiRes();
+        for (int y = 0; y < sums.tilesY; ++y)
+            bitmap.setRow(y, ink.data() + y * sums.tilesX, sums.tilesX);
+        for (int b = 0; b < PrintBitmap::numBands; ++b)
+            bitmap.getBandBytes(b, band);
+        
+        auto t4 = juce::Time::getMillisecondCounterHiRes();
+        sourceMs += t1 - t0;
+        resampleMs += t2 - t1;
+        quantizeMs += t3 - t2;
+        encodeMs += t4 - t3;
+        worstMs = juce::jmax(worstMs, t4 - t1);
     }
     
-    // Seuil pour noir/blanc
-    uint8_t avgGrey = static_cast<uint8_t>(sumGrey / count);
-    return (avgGrey < threshold);
+    auto perFrame = [numFrames](double total) { return juce::String(total / numFrames, 3) + " ms"; };
+    auto pipelineMs = (resampleMs + quantizeMs + encodeMs) / numFrames;
+    
+    return "Pipeline benchmark - " + source.getDescription() + ", " + juce::String(numFrames) + " frames"
+         + "\n  source: " + perFrame(sourceMs)
+         + ", resample: " + perFrame(resampleMs)
+         + ", quantize: " + perFrame(quantizeMs)
+         + ", print encode: " + perFrame(encodeMs)
+         + "\n  pipeline: " + juce::String(pipelineMs, 3) + " ms/frame (worst " + juce::String(worstMs, 3)
+         + " ms), " + juce::String(1000.0 / juce::jmax(pipelineMs, 0.001), 0) + " fps max";
 }
 
+//==============================================================================
 void CameraCapture::startCountdown()
 {
     if (isCountingDown)
@@ -194,119 +570,40 @@ void CameraCapture::takePhoto()
 {
     //La photo devrait faire 192 par 108
     
-    const juce::ScopedLock lock(imageLock);
-    
-    if (!currentFrame.isValid())
-        return;
-    
-    int w = currentFrame.getWidth();
-    int h = currentFrame.getHeight();
-    
-    // Taille de l'image pixelisée réelle
-    int pixelW = w / tileSize;
-    int pixelH = h / tileSize;
-    
-    std::cout << pixelH << std::endl;
-    std::cout << pixelW << std::endl;
+    // Réutilise la dernière frame publiée au lieu de repasser sur l'image
+    if (previewFrames.acquire())
+        updateDisplayImage(previewFrames.getReadBuffer());
     
-    juce::Image pixelImage(juce::Image::RGB, pixelW, pixelH, false);
-    juce::Image::BitmapData src(currentFrame, juce::Image::BitmapData::readOnly);
-    juce::Image::BitmapData dst(pixelImage, juce::Image::BitmapData::writeOnly);
+    const auto& frame = previewFrames.getReadBuffer();
     
-    // Calcul de la couleur moyenne pour chaque bloc
-    for (int by = 0; by < pixelH; ++by)
-    {
-        for (int bx = 0; bx < pixelW; ++bx)
-        {
-            int blockX = bx * tileSize;
-            int blockY = by * tileSize;
-            bool pixRes = processBlockToColour(src, blockX, blockY, w, h);
-            juce::Colour tileColour = pixRes ? juce::Colours::black : juce::Colours::white;
-            dst.setPixelColour(bx, by, tileColour);
-            
-            imgBuffer[bx][by] = pixRes;
-        }
-    }
+    if (frame.tilesX == 0)
+        return;
     
+    // La grille a toujours la taille de la photo imprimée, quelle que soit la caméra
+    printBitmap.clear();
     
-    for (int x = 0; x < 320; x++)
-    {
-        for (int y = 0; y < 192; y++)
-        {
-            if (y < 180) {
-                imgBufferForPrint[y][x] = imgBuffer[x][179-y];
-            } else {
-                imgBufferForPrint[y][x] = 0;
-            }
-            
-        }
-    }
+    for (int by = 0; by < frame.tilesY; ++by)
+        printBitmap.setRow(by, frame.tiles.data() + by * frame.tilesX, frame.tilesX);
     
-    // Sauvegarde
-    auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-        .getChildFile("photo_pixelArt.png");
-    if (file.exists() ) {
-        file.deleteFile();
-    }
-    juce::PNGImageFormat png;
-    juce::FileOutputStream stream(file);
-    png.writeImageToStream(pixelImage, stream);
-    DBG("Photo saved to: " << file.getFullPathName());
+    // Sauvegarde (PBM numéroté + PNG) sur le thread de l'archive
+    photoArchive.add(printBitmap);
     
-    printPhoto();
+    // Impression sur le thread de la file, le thread message reste libre
+    const int jobId = printSpooler.submit(printBitmap);
+    mmRef->getEventLog().add(EventLog::Type::photoTaken, 0, 0, 0, (float) jobId);
+    printProgress = 0.f;
+    repaint(getPrintProgressBounds());
 }
 
-void CameraCapture::printPhoto() {
-    
-    mmRef->sendProgramChange(16, 1);
-    
-    auto buff = imgBufferForPrint;
-    const int maxLen = 320;
-    
-    for (int yy = 0; yy < 14; yy++) {
-        juce::Thread::sleep (4);
-        mmRef->sendControlChange(15, 60, 60);
-        juce::Thread::sleep (4);
-        
-        int yBase = yy * 24;
-        
-        for (int x = 0; x < 192; x++)
-        {
-            for (int byte = 0; byte < 3; byte++)
-            {
-                uint8_t v = 0;
-                
-                for (int bit = 0; bit < 8; bit++)
-                {
-                    int bb = (byte * 8 + bit);
-                    int y = yBase + bb;
-                    
-                    if (y < maxLen && buff[x][y]) {
-                        v |= (1 << (7 - bit));
-                    }
-                }
-                
-                mmRef->sendByteAsMidiForPrinter(v);
-            }
-        }
-        
-        juce::Thread::sleep (4);
-        mmRef->sendControlChange(15, 60, 60);
-        juce::Thread::sleep (5);
-        mmRef->sendNoteOn(1, mmRef->lastNote, 0);
-        mmRef->sendNoteOn(10, mmRef->lastLed, 0);
-        juce::Thread::sleep (4000);
-    }
-    
-    mmRef->sendControlChange(15, 50, 50);
+void CameraCapture::cancelPrint()
+{
+    if (printSpooler.isPrinting() || printSpooler.getNumPendingJobs() > 0)
+        juce::Logger::writeToLog("Cancelling print");
     
-    // Notifier que l'impression est terminée
-    if (onPrintFinished)
-    {
-        juce::MessageManager::callAsync([this]()
-        {
-            if (onPrintFinished)
-                onPrintFinished();
-        });
-    }
+    printSpooler.cancel();
+}
+
+juce::Rectangle<int> CameraCapture::getPrintProgressBounds() const
+{
+    return getLocalBounds().removeFromBottom(40).reduced(20, 10);
 }
@@ -4,10 +4,19 @@
 #include <stdlib.h>
 #include <functional>
 #include "MidiManager.h"
+#include "LumaKernel.h"
+#include "TripleBuffer.h"
+#include "Quantizer.h"
+#include "PrintBitmap.h"
+#include "FrameSource.h"
+#include "LatencyHistogram.h"
+#include "PhotoArchive.h"
+#include "PrintSpooler.h"
 
 class CameraCapture : public juce::Component,
-                      public juce::CameraDevice::Listener,
-                      public juce::Timer
+                      public juce::Timer,
+                      private juce::Thread,
+                      private juce::AsyncUpdater
 {
 public:
     CameraCapture(MidiManager* midiManager);
@@ -17,32 +26,125 @@ public:
     void paint(juce::Graphics& g) override;
     
     void setThreshold(float value);
-    void imageReceived(const juce::Image& image) override;
+    void setQuantizerMode(Quantizer::Mode mode);
+    
+    // Seuil automatique (Otsu) : la valeur courante est lisible pour l'affichage
+    void setAutoThreshold(bool shouldBeAuto);
+    float getAutoThresholdValue() const;
+    
+    // Remplace la caméra par une autre source d'images (synthétique, relecture...)
+    void setFrameSource(std::unique_ptr<FrameSource> newSource);
+    void imageReceived(const juce::Image& image);
     void timerCallback() override;
 
     void startCountdown();
     
-    // Callback appelé quand l'impression est terminée
+    // Compteurs du pipeline (frames perdues, traitées, affichées)
+    juce::String getPipelineStats() const;
+    
+    // Latences par étape, de la réception de l'image jusqu'à son affichage
+    juce::String getLatencyReport() const;
+    void resetLatencyStats();
+    
+    // Débit et latence du pipeline complet (réduction, tramage, bandes d'impression)
+    // sur des images tirées directement de la source, sans caméra ni affichage
+    static juce::String runPipelineBenchmark(TimedFrameSource& source, int numFrames = 100);
+    
+    // Interrompt l'impression en cours et vide la file d'impression
+    void cancelPrint();
+    
+    // Callback appelé sur le thread message quand une impression est terminée ou annulée
     std::function<void()> onPrintFinished;
     
 private:
-    static constexpr int tileSize = 6; // taille de la tuile pour le pixel art
-    void printPhoto();
-    
     void takePhoto();
-    bool processBlockToColour(const juce::Image::BitmapData& src,
-                              int blockX, int blockY,
-                              int imageWidth, int imageHeight);
+    juce::Rectangle<int> getPrintProgressBounds() const;
+    
+    // Thread de traitement
+    void run() override;
+    void handleAsyncUpdate() override;
+    
+    // Frame traitée, publiée par le thread de traitement vers paint().
+    // Les trois slots du triple buffer forment le pool : rien n'est alloué par frame.
+    struct PreviewFrame
+    {
+        PreviewFrame() { tiles.reserve(320 * 180); }
+        
+        int tilesX = 0;
+        int tilesY = 0;
+        std::vector<uint8_t> tiles; // 1 octet par tuile, 1 = noir
+        
+        // Numéro de frame et tuiles dont l'encre a changé depuis la frame précédente
+        uint32_t sequence = 0;
+        juce::Rectangle<int> dirtyTiles;
+        
+        // Horodatages haute résolution des étapes (0 = pas de nouvelle image caméra)
+        juce::int64 receivedTicks = 0;
+        juce::int64 processStartTicks = 0;
+        juce::int64 quantizedTicks = 0;
+        juce::int64 publishedTicks = 0;
+    };
+    
+    bool renderPreview(PreviewFrame& frame, bool requantizeAll);
+    void updateAutoThreshold(const LumaKernel::TileSums& sums);
+    void updateDisplayImage(const PreviewFrame& frame);
     
-    std::unique_ptr<juce::CameraDevice> camera;
-    juce::Image currentFrame;
-    juce::CriticalSection imageLock;
+    std::unique_ptr<FrameSource> frameSource;
 
     juce::TextButton takePhotoButton;
     
-    uint32_t lastUpdateTime = 0;
+    std::atomic<int> threshold { 127 };
+    std::atomic<bool> rerenderRequested { false };
     
-    int threshold = 127;
+    // Seuil automatique : smoothedThreshold n'est utilisé que par le thread de traitement
+    static constexpr float autoThresholdSmoothing = 0.15f;
+    std::atomic<bool> autoThreshold { false };
+    std::atomic<int> autoThresholdValue { 127 };
+    float smoothedThreshold = -1.f;
+    
+    // Dernière image reçue de la caméra, en attente du thread de traitement
+    juce::Image pendingFrame;
+    juce::int64 pendingFrameTicks = 0;
+    juce::SpinLock pendingLock;
+    
+    // Réduction de la caméra vers la grille de la photo (320 x 180),
+    // et sommes de la dernière frame, propres au thread de traitement
+    LumaKernel::TileResampler resampler { PrintBitmap::width, PrintBitmap::height };
+    LumaKernel::TileSums frameSums;
+    std::vector<uint8_t> tileGreys;
+    
+    // Traitement incrémental : seules les tuiles qui ont changé sont recalculées,
+    // avec un recalcul complet régulier pour rattraper les dérives lentes
+    static constexpr int fullRefreshInterval = 60;
+    int framesSinceFullRefresh = 0;
+    std::vector<uint8_t> tileDirty;
+    std::vector<uint8_t> currentInk, quantizedInk;
+    int lastQuantizedThreshold = -1;
+    uint32_t publishedSequence = 0;
+    
+    // Tuiles à redessiner, accumulées jusqu'au prochain handleAsyncUpdate()
+    juce::Rectangle<int> pendingRepaintTiles;
+    juce::SpinLock repaintLock;
+    
+    // Quantificateur courant, recréé par le thread de traitement quand le mode change
+    std::atomic<int> quantizerMode { (int)Quantizer::Mode::threshold };
+    std::unique_ptr<Quantizer> quantizer;
+    int activeQuantizerMode = -1;
+    
+    TripleBuffer<PreviewFrame> previewFrames;
+    juce::Image displayImage; // thread message uniquement
+    float printProgress = -1.f; // thread message uniquement, -1 hors impression
+    uint32_t displayedSequence = 0;
+    
+    std::atomic<uint32_t> framesDropped { 0 };      // frames caméra remplacées avant traitement
+    std::atomic<uint32_t> framesOverwritten { 0 };  // frames publiées jamais affichées
+    std::atomic<uint32_t> framesProcessed { 0 };
+    std::atomic<uint32_t> framesDisplayed { 0 };
+    std::atomic<uint64_t> tilesRecomputed { 0 };
+    
+    // Réception -> prise en charge, réduction + tramage, publication -> paint,
+    // durée du paint, et réception -> affichage
+    LatencyHistogram queueLatency, quantizeLatency, displayLatency, paintLatency, endToEndLatency;
     
     // Variables pour le décompte
     int countdownValue = 0;
@@ -50,6 +152,15 @@ private:
     
     MidiManager* mmRef = nullptr;
 
-    bool imgBuffer[320][180];
-    bool imgBufferForPrint[192][320];
+    // Photo compactée à 1 bit par pixel, prête pour l'imprimante
+    PrintBitmap printBitmap;
+    
+    // Toutes les photos, numérotées, écrites hors du thread message
+    PhotoArchive photoArchive {
+        juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("BIS_Archive"),
+        juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("photo_pixelArt.png")
+    };
+    
+    // Impression sur un thread dédié (après mmRef, qu'elle utilise)
+    PrintSpooler printSpooler { mmRef };
 };
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    EventJournal.h
+    Journal sur disque : une ligne JSON par événement, fichiers tournants
+    limités en taille.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Un seul écrivain (le thread d'EventLog) : les lignes passent par le tampon
+    du FileOutputStream, flush() les écrit et synchronise le fichier sur le
+    disque (fsync).
+
+    Chaque lancement ouvre un nouveau fichier journal_AAAAMMJJ_HHMMSS_NNN.jsonl ;
+    au-delà de maxFileBytes on passe au fichier suivant, et seuls les
+    maxFiles fichiers les plus récents sont gardés.
+
+    Si le fichier ne peut pas être ouvert, ou si une écriture ou une
+    synchronisation échoue (disque plein, volume retiré), l'erreur est écrite
+    une fois avec juce::Logger, le fichier est abandonné et l'ouverture d'un
+    nouveau n'est retentée qu'au bout de openRetryMs ; les lignes perdues
+    entre-temps sont comptées et signalées à la reprise.
+*/
+class EventJournal
+{
+public:
+    EventJournal (const juce::File& directoryToUse, juce::int64 maxFileBytesToUse = 4 * 1024 * 1024, int maxFilesToUse = 10)
+        : directory (directoryToUse), maxFileBytes (maxFileBytesToUse), maxFiles (maxFilesToUse)
+    {
+    }
+
+    ~EventJournal()
+    {
+        flush();
+    }
+
+    //==============================================================================
+    void write (const juce::String& line)
+    {
+        if (stream == nullptr || stream->getPosition() >= maxFileBytes)
+        {
+            if (! openNextFile())
+            {
+                ++numLinesLost;
+                return;
+            }
+        }
+
+        ++numUnsyncedLines;
+
+        if (! stream->writeText (line + "\n", false, false, nullptr) || stream->getStatus().failed())
+            abandonFile();
+    }
+
+    void flush()
+    {
+        if (stream != nullptr && numUnsyncedLines > 0)
+        {
+            stream->flush();
+
+            if (stream->getStatus().failed())
+                abandonFile();
+            else
+                numUnsyncedLines = 0;
+        }
+    }
+
+private:
+    //==============================================================================
+    bool openNextFile()
+    {
+        flush();
+        stream.reset();
+
+        const auto now = juce::Time::getMillisecondCounter();
+
+        if (openFailed && now - lastOpenAttemptMs < openRetryMs)
+            return false;
+
+        lastOpenAttemptMs = now;
+
+        if (! directory.createDirectory())
+            return reportFailure (directory);
+
+        // Le numéro ne redescend jamais : un fichier supprimé n'est pas réutilisé
+        // par une rotation dans la même seconde
+        const auto name = "journal_" + juce::Time::getCurrentTime().formatted ("%Y%m%d_%H%M%S") + "_";
+        juce::File file;
+
+        do
+            file = directory.getChildFile (name + juce::String (fileIndex++).paddedLeft ('0', 3) + ".jsonl");
+        while (file.exists());
+
+        stream = std::make_unique<juce::FileOutputStream> (file, 64 * 1024);
+
+        if (! stream->openedOk())
+        {
+            stream.reset();
+            return reportFailure (file);
+        }
+
+        if (openFailed)
+            juce::Logger::writeToLog ("Event journal: writing to " + file.getFullPathName() + " again, "
+                                      + juce::String (numLinesLost) + " line(s) lost");
+
+        openFailed = false;
+        numLinesLost = 0;
+
+        removeOldFiles();
+        return true;
+    }
+
+    // Les lignes pas encore synchronisées sont considérées perdues : on ne sait
+    // pas lesquelles ont atteint le disque
+    void abandonFile()
+    {
+        const auto file = stream->getFile();
+
+        numLinesLost += numUnsyncedLines;
+        numUnsyncedLines = 0;
+        stream.reset();
+
+        lastOpenAttemptMs = juce::Time::getMillisecondCounter();
+        reportFailure (file);
+    }
+
+    // Une seule fois jusqu'à la prochaine ouverture réussie
+    bool reportFailure (const juce::File& file)
+    {
+        if (! openFailed)
+            juce::Logger::writeToLog ("Event journal: cannot write " + file.getFullPathName()
+                                      + ", retrying every " + juce::String ((int) (openRetryMs / 1000)) + " s");
+
+        openFailed = true;
+        return false;
+    }
+
+    // Les noms commencent par la date : l'ordre alphabétique est l'ordre chronologique
+    void removeOldFiles()
+    {
+        auto files = directory.findChildFiles (juce::File::findFiles, false, "journal_*.jsonl");
+        files.sort();
+
+        for (int i = 0; i < files.size() - maxFiles; ++i)
+            files.getReference (i).deleteFile();
+    }
+
+    //==============================================================================
+    const juce::File directory;
+    const juce::int64 maxFileBytes;
+    const int maxFiles;
+
+    static constexpr juce::uint32 openRetryMs = 10000;
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    int fileIndex = 0;
+    int numUnsyncedLines = 0;
+
+    bool openFailed = false;
+    juce::uint32 lastOpenAttemptMs = 0;
+    int numLinesLost = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventJournal)
+};
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    EventLog.h
+    Journal binaire des événements MIDI et du spectacle : enregistrements
+    compacts sans verrou, mis en forme plus tard par un thread de faible
+    priorité.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "MpscQueue.h"
+#include "EventJournal.h"
+
+//==============================================================================
+/**
+    add() et addMidi() copient 16 octets dans une file sans verrou (MpscQueue) :
+    ni allocation, ni chaîne de caractères, ni Logger sur le thread appelant
+    (thread MIDI, thread d'impression, thread message).
+
+    Le thread du journal vide la file toutes les 50 ms, met chaque
+    enregistrement en forme et l'écrit avec juce::Logger ; les textes sont
+    ceux des anciens appels directs ("MIDI OUT Note On - Channel: ...").
+
+    Le même thread ajoute chaque enregistrement, en JSON, au journal sur disque
+    (EventJournal) et le synchronise au plus une fois par seconde : seul ce
+    thread touche au fichier.
+
+    Si la file est pleine, l'enregistrement est perdu et compté ; le nombre de
+    pertes est écrit dans le journal à la passe suivante.
+*/
+class EventLog : private juce::Thread
+{
+public:
+    enum class Type : uint8_t
+    {
+        midiOut,        // status, data1, data2 : message envoyé
+        midiIn,         // status, data1, data2 : message reçu
+        noteThrottled,  // data1 = note, value = ms depuis la note précédente
+        programLoaded,  // data1 = numéro de la note du programme
+        photoTaken,     // value = numéro du travail d'impression
+        printStarted,   // data1 = SysEx, data2 = compression, value = numéro du travail
+        printFinished,  // data1 = terminé (0 si annulé), value = numéro du travail
+        recordsDropped  // value = nombre d'enregistrements perdus (file pleine)
+    };
+
+    struct Record
+    {
+        double timeMs = 0.0;    // Time::getMillisecondCounterHiRes()
+        Type type = Type::midiOut;
+        uint8_t status = 0;
+        uint8_t data1 = 0;
+        uint8_t data2 = 0;
+        float value = 0.f;
+    };
+
+    explicit EventLog (const juce::File& journalDirectoryToUse = getDefaultJournalDirectory())
+        : juce::Thread ("Event log"), queue (queueCapacity), journalDirectory (journalDirectoryToUse)
+    {
+        startThread (juce::Thread::Priority::low);
+    }
+
+    // Les enregistrements en file sont écrits avant de rendre la main
+    ~EventLog() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (2000);
+    }
+
+    //==============================================================================
+    // N'importe quel thread, sans bloquer
+    void add (Type type, uint8_t status = 0, uint8_t data1 = 0, uint8_t data2 = 0, float value = 0.f) noexcept
+    {
+        push ({ juce::Time::getMillisecondCounterHiRes(), type, status, data1, data2, value });
+    }
+
+    // Messages courts uniquement (notes, contrôleurs, changements de programme) ;
+    // timeMs permet de garder l'heure d'arrivée d'un message reçu
+    void addMidi (Type type, const juce::MidiMessage& message, double timeMs = 0.0) noexcept
+    {
+        const auto* data = message.getRawData();
+        const int size = message.getRawDataSize();
+
+        push ({ timeMs > 0.0 ? timeMs : juce::Time::getMillisecondCounterHiRes(), type,
+                data[0], size > 1 ? data[1] : (uint8_t) 0, size > 2 ? data[2] : (uint8_t) 0, 0.f });
+    }
+
+    static juce::File getDefaultJournalDirectory()
+    {
+        return juce::File::getSpecialLocation (juce::File::userDesktopDirectory).getChildFile ("BIS_Journal");
+    }
+
+    //==============================================================================
+    static juce::String format (const Record& record)
+    {
+        const int channel = (record.status & 0x0F) + 1;
+
+        switch (record.type)
+        {
+            case Type::noteThrottled:
+                return "Note On throttled (ignored) - " + juce::String (record.value) + "ms since last";
+
+            case Type::programLoaded:
+                return "Program loaded - Note: " + juce::String (record.data1);
+
+            case Type::photoTaken:
+                return "Photo taken - Print job " + juce::String ((int) record.value);
+
+            case Type::printStarted:
+                return "Print job " + juce::String ((int) record.value) + " started ("
+                     + (record.data1 != 0 ? "SysEx" : "notes") + (record.data2 != 0 ? ", compressed)" : ")");
+
+            case Type::printFinished:
+                return "Print job " + juce::String ((int) record.value) + (record.data1 != 0 ? " finished" : " cancelled");
+
+            case Type::recordsDropped:
+                return "Event log full: " + juce::String ((int) record.value) + " record(s) dropped";
+
+            case Type::midiOut:
+            case Type::midiIn:
+            default:
+                break;
+        }
+
+        juce::String text (record.type == Type::midiOut ? "MIDI OUT " : "MIDI IN ");
+
+        switch (record.status & 0xF0)
+        {
+            case 0x90:
+            case 0x80:
+                return text + ((record.status & 0xF0) == 0x90 ? "Note On" : "Note Off")
+                     + " - Channel: " + juce::String (channel) + ", Note: " + juce::String (record.data1)
+                     + ", Velocity: " + juce::String (record.data2);
+
+            case 0xC0:
+                return text + "Program Change - Channel: " + juce::String (channel)
+                     + ", Program: " + juce::String (record.data1);
+
+            case 0xB0:
+                return text + "Control Change - Channel: " + juce::String (channel)
+                     + ", CC: " + juce::String (record.data1) + ", Value: " + juce::String (record.data2);
+
+            default:
+                return text + juce::String::toHexString (record.status) + " " + juce::String::toHexString (record.data1)
+                     + " " + juce::String::toHexString (record.data2);
+        }
+    }
+
+    // Une ligne du journal ; wallClockOffsetMs convertit timeMs en heure absolue
+    static juce::String toJson (const Record& record, double wallClockOffsetMs)
+    {
+        const auto time = juce::Time ((juce::int64) (record.timeMs + wallClockOffsetMs));
+
+        return "{\"time\":\"" + time.toISO8601 (true) + "\",\"ms\":" + juce::String (record.timeMs, 3)
+             + ",\"type\":\"" + getTypeName (record.type) + "\",\"status\":" + juce::String (record.status)
+             + ",\"data1\":" + juce::String (record.data1) + ",\"data2\":" + juce::String (record.data2)
+             + ",\"value\":" + juce::String (record.value) + "}";
+    }
+
+    static const char* getTypeName (Type type)
+    {
+        switch (type)
+        {
+            case Type::midiOut:         return "midiOut";
+            case Type::midiIn:          return "midiIn";
+            case Type::noteThrottled:   return "noteThrottled";
+            case Type::programLoaded:   return "programLoaded";
+            case Type::photoTaken:      return "photoTaken";
+            case Type::printStarted:    return "printStarted";
+            case Type::printFinished:   return "printFinished";
+            case Type::recordsDropped:  return "recordsDropped";
+            default:                    return "unknown";
+        }
+    }
+
+private:
+    //==============================================================================
+    void push (Record record) noexcept
+    {
+        if (! queue.push (std::move (record)))
+            ++numDropped;
+    }
+
+    void run() override
+    {
+        // Le fichier est ouvert par ce thread, jamais par l'appelant
+        EventJournal journal (journalDirectory);
+        double lastSyncMs = juce::Time::getMillisecondCounterHiRes();
+
+        while (! threadShouldExit())
+        {
+            wait (50);
+            writePendingRecords (journal);
+
+            const double now = juce::Time::getMillisecondCounterHiRes();
+
+            if (now - lastSyncMs >= journalSyncMs)
+            {
+                journal.flush();
+                lastSyncMs = now;
+            }
+        }
+
+        writePendingRecords (journal);
+    }
+
+    void writePendingRecords (EventJournal& journal)
+    {
+        // Recalculé à chaque passe : suit les changements d'heure du système
+        const double wallClockOffsetMs = (double) juce::Time::currentTimeMillis() - juce::Time::getMillisecondCounterHiRes();
+
+        auto write = [&] (const Record& record)
+        {
+            juce::Logger::writeToLog (format (record));
+            journal.write (toJson (record, wallClockOffsetMs));
+        };
+
+        if (const int dropped = numDropped.exchange (0))
+            write ({ juce::Time::getMillisecondCounterHiRes(), Type::recordsDropped, 0, 0, 0, (float) dropped });
+
+        Record record;
+
+        while (queue.pop (record))
+            write (record);
+    }
+
+    //==============================================================================
+    static constexpr int queueCapacity = 8192;
+    static constexpr double journalSyncMs = 1000.0;
+
+    MpscQueue<Record> queue;
+    const juce::File journalDirectory;
+    std::atomic<int> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLog)
+};
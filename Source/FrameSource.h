@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+    FrameSource.h
+    Sources d'images pour CameraCapture : caméra, générateur synthétique, et
+    relecture d'un dossier de PNG ou d'un enregistrement brut.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+
+//==============================================================================
+/**
+    Source d'images : onFrame est appelé depuis le thread de la source, comme
+    CameraDevice::Listener::imageReceived.
+*/
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual juce::String getDescription() const = 0;
+
+    std::function<void(const juce::Image&)> onFrame;
+
+    // --frames=camera | synthetic[:gradient|noise|shapes] | <dossier de PNG> | <fichier .raw>
+    // --fps=<images par seconde>, --size=<largeur>x<hauteur> (synthétique)
+    static std::unique_ptr<FrameSource> createFromCommandLine (const juce::StringArray& args);
+};
+
+//==============================================================================
+// Caméra JUCE (indisponible sur les machines Linux)
+class CameraFrameSource : public FrameSource,
+                          private juce::CameraDevice::Listener
+{
+public:
+    explicit CameraFrameSource (int deviceIndexToUse = 0) : deviceIndex (deviceIndexToUse) {}
+    ~CameraFrameSource() override { stop(); }
+
+    bool start() override
+    {
+        camera.reset (juce::CameraDevice::openDevice (deviceIndex));
+
+        if (camera == nullptr)
+            return false;
+
+        camera->addListener (this);
+        return true;
+    }
+
+    void stop() override
+    {
+        if (camera != nullptr)
+            camera->removeListener (this);
+
+        camera.reset();
+    }
+
+    juce::String getDescription() const override
+    {
+        return "Camera " + (camera != nullptr ? camera->getName() : juce::String (deviceIndex));
+    }
+
+private:
+    void imageReceived (const juce::Image& image) override
+    {
+        if (onFrame)
+            onFrame (image);
+    }
+
+    int deviceIndex;
+    std::unique_ptr<juce::CameraDevice> camera;
+};
+
+//==============================================================================
+/**
+    Source cadencée par son propre thread. renderNextFrame() peut aussi être
+    appelée directement (sans démarrer le thread) pour les benchmarks.
+*/
+class TimedFrameSource : public FrameSource,
+                         protected juce::Thread
+{
+public:
+    TimedFrameSource (const juce::String& threadName, double framesPerSecond)
+        : juce::Thread (threadName), fps (juce::jmax (0.1, framesPerSecond))
+    {
+    }
+
+    ~TimedFrameSource() override { stopThread (2000); }
+
+    bool start() override           { return startThread(); }
+    void stop() override            { stopThread (2000); }
+
+    virtual juce::Image renderNextFrame() = 0;
+
+protected:
+    void run() override
+    {
+        auto nextFrameTime = juce::Time::getMillisecondCounterHiRes();
+
+        while (! threadShouldExit())
+        {
+            auto image = renderNextFrame();
+
+            if (image.isValid() && onFrame)
+                onFrame (image);
+
+            nextFrameTime += 1000.0 / fps;
+            auto delay = nextFrameTime - juce::Time::getMillisecondCounterHiRes();
+
+            if (delay > 0)
+                wait (delay);
+            else
+                nextFrameTime = juce::Time::getMillisecondCounterHiRes(); // en retard : on ne rattrape pas
+        }
+    }
+
+    const double fps;
+};
+
+//==============================================================================
+// Générateur d'images : dégradé animé, bruit ou formes en mouvement
+class SyntheticFrameSource : public TimedFrameSource
+{
+public:
+    enum class Pattern
+    {
+        gradient,
+        noise,
+        movingShapes
+    };
+
+    SyntheticFrameSource (int widthToUse, int heightToUse, double framesPerSecond, Pattern patternToUse)
+        : TimedFrameSource ("Synthetic frames", framesPerSecond),
+          width (widthToUse), height (heightToUse), pattern (patternToUse)
+    {
+    }
+
+    ~SyntheticFrameSource() override { stop(); }
+
+    juce::String getDescription() const override
+    {
+        static const char* names[] = { "gradient", "noise", "shapes" };
+        return "Synthetic " + juce::String (names[(int) pattern]) + " " + juce::String (width) + "x"
+             + juce::String (height) + " @ " + juce::String (fps, 1) + " fps";
+    }
+
+    // Une nouvelle image par frame, comme une vraie caméra
+    juce::Image renderNextFrame() override
+    {
+        juce::Image image (juce::Image::ARGB, width, height, false);
+        const float t = (float) frameNumber++ / (float) fps;
+
+        if (pattern == Pattern::noise)
+        {
+            juce::Image::BitmapData data (image, juce::Image::BitmapData::writeOnly);
+
+            for (int y = 0; y < height; ++y)
+            {
+                auto* line = reinterpret_cast<uint32_t*> (data.getLinePointer (y));
+
+                for (int x = 0; x < width; ++x)
+                {
+                    auto v = (uint32_t) random.nextInt (256);
+                    line[x] = 0xff000000u | (v << 16) | (v << 8) | v;
+                }
+            }
+
+            return image;
+        }
+
+        juce::Graphics g (image);
+        auto phase = std::fmod (t * 0.2f, 1.0f);
+
+        g.setGradientFill (juce::ColourGradient (juce::Colours::black, (float) width * (phase - 1.0f), 0.0f,
+                                                 juce::Colours::white, (float) width * phase, 0.0f, false));
+        g.fillAll();
+
+        if (pattern == Pattern::movingShapes)
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                auto radius = (float) height * (0.08f + 0.03f * (float) i);
+                auto cx = (float) width * (0.5f + 0.4f * std::sin (t * (0.7f + 0.3f * (float) i) + (float) i));
+                auto cy = (float) height * (0.5f + 0.35f * std::cos (t * (0.5f + 0.2f * (float) i) + 2.0f * (float) i));
+
+                g.setColour (i % 2 == 0 ? juce::Colours::black : juce::Colours::darkgrey);
+                g.fillEllipse (cx - radius, cy - radius, radius * 2.0f, radius * 2.0f);
+            }
+        }
+
+        return image;
+    }
+
+private:
+    const int width;
+    const int height;
+    const Pattern pattern;
+    int64_t frameNumber = 0;
+    juce::Random random { 1234 };
+};
+
+//==============================================================================
+/**
+    Relecture en boucle d'images enregistrées :
+    - un dossier de PNG, lus dans l'ordre alphabétique ;
+    - un fichier .raw : en-tête "BISR", largeur, hauteur, octets par pixel
+      (uint32 little-endian, 1, 3 ou 4), puis les frames brutes à la suite,
+      dans l'ordre des octets de juce::Image (SingleChannel, RGB ou ARGB).
+*/
+class ReplayFrameSource : public TimedFrameSource
+{
+public:
+    ReplayFrameSource (const juce::File& sourceToUse, double framesPerSecond)
+        : TimedFrameSource ("Replay frames", framesPerSecond), source (sourceToUse)
+    {
+        if (source.isDirectory())
+        {
+            source.findChildFiles (pngFiles, juce::File::findFiles, false, "*.png");
+            pngFiles.sort();
+        }
+        else
+        {
+            openRawFile();
+        }
+    }
+
+    ~ReplayFrameSource() override { stop(); }
+
+    juce::String getDescription() const override
+    {
+        auto count = rawStream != nullptr ? juce::String (numRawFrames) + " raw frames"
+                                          : juce::String (pngFiles.size()) + " PNG";
+        return "Replay " + source.getFullPathName() + " (" + count + ") @ " + juce::String (fps, 1) + " fps";
+    }
+
+    bool isValid() const    { return pngFiles.size() > 0 || numRawFrames > 0; }
+
+    juce::Image renderNextFrame() override
+    {
+        if (pngFiles.size() > 0)
+        {
+            auto file = pngFiles[(int) (frameNumber++ % pngFiles.size())];
+            return juce::ImageFileFormat::loadFrom (file);
+        }
+
+        if (numRawFrames == 0)
+            return {};
+
+        auto index = frameNumber++ % numRawFrames;
+        auto format = bytesPerPixel == 4 ? juce::Image::ARGB : (bytesPerPixel == 3 ? juce::Image::RGB : juce::Image::SingleChannel);
+        juce::Image image (format, rawWidth, rawHeight, false);
+
+        rawStream->setPosition (rawHeaderSize + index * (int64_t) rawWidth * rawHeight * bytesPerPixel);
+
+        juce::Image::BitmapData data (image, juce::Image::BitmapData::writeOnly);
+        for (int y = 0; y < rawHeight; ++y)
+            rawStream->read (data.getLinePointer (y), rawWidth * bytesPerPixel);
+
+        return image;
+    }
+
+private:
+    void openRawFile()
+    {
+        rawStream = source.createInputStream();
+
+        if (rawStream == nullptr)
+            return;
+
+        char magic[4] = {};
+        rawStream->read (magic, 4);
+        rawWidth = rawStream->readInt();
+        rawHeight = rawStream->readInt();
+        bytesPerPixel = rawStream->readInt();
+
+        auto frameSize = (int64_t) rawWidth * rawHeight * bytesPerPixel;
+
+        if (std::memcmp (magic, "BISR", 4) != 0 || frameSize <= 0
+             || (bytesPerPixel != 1 && bytesPerPixel != 3 && bytesPerPixel != 4))
+        {
+            rawStream.reset();
+            return;
+        }
+
+        numRawFrames = (rawStream->getTotalLength() - rawHeaderSize) / frameSize;
+    }
+
+    static constexpr int64_t rawHeaderSize = 16;
+
+    juce::File source;
+    juce::Array<juce::File> pngFiles;
+    std::unique_ptr<juce::FileInputStream> rawStream;
+    int rawWidth = 0, rawHeight = 0, bytesPerPixel = 0;
+    int64_t numRawFrames = 0;
+    int64_t frameNumber = 0;
+};
+
+//==============================================================================
+inline std::unique_ptr<FrameSource> FrameSource::createFromCommandLine (const juce::StringArray& args)
+{
+    juce::String frames, size ("1920x1080");
+    double fps = 30.0;
+
+    for (auto& arg : args)
+    {
+        if (arg.startsWith ("--frames="))   frames = arg.fromFirstOccurrenceOf ("=", false, false).unquoted();
+        if (arg.startsWith ("--fps="))      fps = arg.fromFirstOccurrenceOf ("=", false, false).getDoubleValue();
+        if (arg.startsWith ("--size="))     size = arg.fromFirstOccurrenceOf ("=", false, false);
+    }
+
+    if (frames.isEmpty() || frames == "camera")
+        return {};
+
+    if (frames.startsWith ("synthetic"))
+    {
+        auto name = frames.fromFirstOccurrenceOf (":", false, false);
+        auto pattern = name == "noise"    ? SyntheticFrameSource::Pattern::noise
+                     : name == "gradient" ? SyntheticFrameSource::Pattern::gradient
+                                          : SyntheticFrameSource::Pattern::movingShapes;
+
+        return std::make_unique<SyntheticFrameSource> (juce::jmax (1, size.upToFirstOccurrenceOf ("x", false, true).getIntValue()),
+                                                       juce::jmax (1, size.fromFirstOccurrenceOf ("x", false, true).getIntValue()),
+                                                       fps, pattern);
+    }
+
+    auto replay = std::make_unique<ReplayFrameSource> (juce::File::getCurrentWorkingDirectory().getChildFile (frames), fps);
+
+    if (! replay->isValid())
+    {
+        juce::Logger::writeToLog ("No frames to replay in " + frames);
+        return {};
+    }
+
+    return replay;
+}
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    LatencyHistogram.h
+    Histogramme de latences sans verrou, à buckets logarithmiques (style HDR).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/**
+    Latences en microsecondes : valeurs exactes jusqu'à 32 us, puis 16 buckets
+    par octave (précision ~6 %) jusqu'à plus d'une heure.
+
+    record() peut être appelé depuis n'importe quel thread sans bloquer ;
+    la lecture (percentiles, rapport) est approximative pendant l'écriture.
+*/
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()      { reset(); }
+
+    // Horodatage haute résolution à passer à record()
+    static juce::int64 now() noexcept       { return juce::Time::getHighResolutionTicks(); }
+
+    void record (juce::int64 startTicks, juce::int64 endTicks) noexcept
+    {
+        if (startTicks == 0 || endTicks < startTicks)
+            return;
+
+        recordMicroseconds ((uint64_t) (juce::Time::highResolutionTicksToSeconds (endTicks - startTicks) * 1.0e6));
+    }
+
+    void recordMicroseconds (uint64_t us) noexcept
+    {
+        counts[getBucketIndex (us)].fetch_add (1, std::memory_order_relaxed);
+        totalCount.fetch_add (1, std::memory_order_relaxed);
+        totalMicroseconds.fetch_add (us, std::memory_order_relaxed);
+
+        auto previousMax = maxMicroseconds.load (std::memory_order_relaxed);
+        while (us > previousMax && ! maxMicroseconds.compare_exchange_weak (previousMax, us, std::memory_order_relaxed))
+        {}
+    }
+
+    void reset() noexcept
+    {
+        for (auto& c : counts)
+            c.store (0, std::memory_order_relaxed);
+
+        totalCount = 0;
+        totalMicroseconds = 0;
+        maxMicroseconds = 0;
+    }
+
+    //==============================================================================
+    uint64_t getCount() const noexcept      { return totalCount.load (std::memory_order_relaxed); }
+    double getMaxMs() const noexcept        { return (double) maxMicroseconds.load (std::memory_order_relaxed) / 1000.0; }
+
+    double getMeanMs() const noexcept
+    {
+        auto n = getCount();
+        return n > 0 ? (double) totalMicroseconds.load (std::memory_order_relaxed) / (1000.0 * (double) n) : 0.0;
+    }
+
+    // Borne haute du bucket contenant le percentile demandé (0 à 100)
+    double getPercentileMs (double percentile) const noexcept
+    {
+        uint64_t n = 0;
+        for (auto& c : counts)
+            n += c.load (std::memory_order_relaxed);
+
+        if (n == 0)
+            return 0.0;
+
+        auto target = (uint64_t) std::ceil ((double) n * juce::jlimit (0.0, 100.0, percentile) / 100.0);
+        uint64_t seen = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            seen += counts[i].load (std::memory_order_relaxed);
+
+            if (seen >= juce::jmax ((uint64_t) 1, target))
+                return juce::jmin ((double) getBucketUpperBound (i) / 1000.0, getMaxMs());
+        }
+
+        return getMaxMs();
+    }
+
+    juce::String toString (const juce::String& name) const
+    {
+        if (getCount() == 0)
+            return name + ": -";
+
+        auto ms = [] (double v) { return juce::String (v, 2); };
+
+        return name + ": n=" + juce::String ((juce::int64) getCount())
+             + " mean " + ms (getMeanMs())
+             + " p50 " + ms (getPercentileMs (50.0))
+             + " p90 " + ms (getPercentileMs (90.0))
+             + " p99 " + ms (getPercentileMs (99.0))
+             + " max " + ms (getMaxMs()) + " ms";
+    }
+
+private:
+    //==============================================================================
+    static constexpr int subBucketBits = 4;
+    static constexpr int subBuckets = 1 << subBucketBits;
+    static constexpr int numBuckets = 2 * subBuckets + (31 - subBucketBits) * subBuckets;
+
+    static int getBucketIndex (uint64_t us) noexcept
+    {
+        auto v = (uint32_t) juce::jmin (us, (uint64_t) 0xffffffffu);
+
+        if (v < 2 * subBuckets)
+            return (int) v;
+
+        int msb = 31;
+        while ((v & (1u << msb)) == 0)
+            --msb;
+
+        const int shift = msb - subBucketBits;
+        return 2 * subBuckets + (shift - 1) * subBuckets + (int) ((v >> shift) - subBuckets);
+    }
+
+    static uint64_t getBucketUpperBound (int index) noexcept
+    {
+        if (index < 2 * subBuckets)
+            return (uint64_t) index;
+
+        const int k = index - 2 * subBuckets;
+        const int shift = k / subBuckets + 1;
+        return (((uint64_t) (subBuckets + k % subBuckets) + 1) << shift) - 1;
+    }
+
+    std::atomic<uint32_t> counts[numBuckets];
+    std::atomic<uint64_t> totalCount { 0 };
+    std::atomic<uint64_t> totalMicroseconds { 0 };
+    std::atomic<uint64_t> maxMicroseconds { 0 };
+};
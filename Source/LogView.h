@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    LogView.h
+    Vue du log à mémoire constante : anneau de lignes de taille fixe, affiché
+    par une ListBox qui ne dessine que les lignes visibles.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <vector>
+
+//==============================================================================
+/**
+    append() peut être appelé depuis n'importe quel thread : le message est mis
+    de côté sous verrou, sans toucher à l'interface.
+
+    Au plus une fois par image (30 Hz), le timer verse les messages en attente
+    dans l'anneau (maxLines lignes, les plus anciennes sont écrasées), met à
+    jour la ListBox et reste en bas si la vue y était déjà.
+*/
+class LogView : public juce::Component,
+                private juce::ListBoxModel,
+                private juce::Timer
+{
+public:
+    static constexpr int maxLines = 2000;
+
+    LogView()
+        : lines ((size_t) maxLines),
+          font (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain)
+    {
+        listBox.setModel (this);
+        listBox.setRowHeight (14);
+        listBox.setColour (juce::ListBox::backgroundColourId, juce::Colours::black);
+        listBox.setWantsKeyboardFocus (false); // Les raccourcis restent à MainComponent
+        addAndMakeVisible (listBox);
+
+        startTimerHz (30);
+    }
+
+    ~LogView() override
+    {
+        stopTimer();
+        listBox.setModel (nullptr);
+    }
+
+    //==============================================================================
+    // N'importe quel thread
+    void append (const juce::String& message)
+    {
+        const juce::ScopedLock sl (pendingLock);
+
+        // Les messages en trop seraient de toute façon sortis de l'anneau
+        if ((int) pending.size() >= maxLines)
+            pending.pop_front();
+
+        pending.push_back (message);
+    }
+
+    void resized() override
+    {
+        listBox.setBounds (getLocalBounds());
+    }
+
+private:
+    //==============================================================================
+    void timerCallback() override
+    {
+        std::deque<juce::String> messages;
+        {
+            const juce::ScopedLock sl (pendingLock);
+            std::swap (messages, pending);
+        }
+
+        if (messages.empty())
+            return;
+
+        auto* scrollBar = listBox.getVerticalScrollBar();
+        const bool wasAtBottom = ! scrollBar->isVisible()
+                                  || scrollBar->getCurrentRangeStart() + scrollBar->getCurrentRangeSize() >= scrollBar->getMaximumRangeLimit() - 1.0;
+
+        for (auto& message : messages)
+            for (auto& line : juce::StringArray::fromLines (message))
+                addLine ("> " + line);
+
+        listBox.updateContent();
+
+        if (wasAtBottom)
+            listBox.scrollToEnsureRowIsOnscreen (numLines - 1);
+
+        listBox.repaint();
+    }
+
+    void addLine (const juce::String& line)
+    {
+        lines[(size_t) ((firstLine + numLines) % maxLines)] = line;
+
+        if (numLines < maxLines)
+            ++numLines;
+        else
+            firstLine = (firstLine + 1) % maxLines;
+    }
+
+    //==============================================================================
+    int getNumRows() override       { return numLines; }
+
+    void paintListBoxItem (int row, juce::Graphics& g, int width, int height, bool) override
+    {
+        if (row < 0 || row >= numLines)
+            return;
+
+        g.setColour (juce::Colours::lightgreen);
+        g.setFont (font);
+        g.drawText (lines[(size_t) ((firstLine + row) % maxLines)], 4, 0, width - 8, height,
+                    juce::Justification::centredLeft, true);
+    }
+
+    //==============================================================================
+    juce::ListBox listBox;
+    std::vector<juce::String> lines;
+    int firstLine = 0;
+    int numLines = 0;
+    juce::Font font;
+
+    juce::CriticalSection pendingLock;
+    std::deque<juce::String> pending;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LogView)
+};
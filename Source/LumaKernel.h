@@ -0,0 +1,681 @@
+/*
+  ==============================================================================
+
+    LumaKernel.h
+    Calcul de la luminance et des sommes par tuile directement sur les lignes
+    brutes de juce::Image::BitmapData (SSE2 / AVX2, avec repli NEON).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <cstring>
+
+#if defined (__AVX2__)
+ #include <immintrin.h>
+ #define BIS_LUMA_AVX2 1
+#elif defined (__SSE2__) || defined (_M_X64)
+ #include <emmintrin.h>
+ #define BIS_LUMA_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define BIS_LUMA_NEON 1
+#endif
+
+//==============================================================================
+/**
+    Luminance en virgule fixe : Y = (77 R + 150 G + 29 B) >> 8
+    (équivalent entier de 0.299 / 0.587 / 0.114).
+*/
+namespace LumaKernel
+{
+    static constexpr int weightR = 77;
+    static constexpr int weightG = 150;
+    static constexpr int weightB = 29;
+
+    //==============================================================================
+    // Sommes de luminance par tuile pour une frame
+    struct TileSums
+    {
+        int sourceWidth = 0;
+        int sourceHeight = 0;
+        int tilesX = 0;
+        int tilesY = 0;
+        std::vector<uint32_t> sums;
+        std::vector<uint16_t> counts;
+        std::vector<uint8_t> line;   // ligne de travail, réutilisée d'une frame à l'autre
+        uint32_t histogram[256] = {}; // histogramme de luminance (si demandé)
+        bool hasHistogram = false;
+
+        void resize (int newTilesX, int newTilesY, int lineWidth)
+        {
+            tilesX = newTilesX;
+            tilesY = newTilesY;
+            sums.resize ((size_t) (tilesX * tilesY));
+            counts.resize ((size_t) (tilesX * tilesY));
+            line.resize ((size_t) lineWidth);
+        }
+
+        uint8_t getAverage (int tx, int ty) const
+        {
+            auto i = (size_t) (ty * tilesX + tx);
+            return counts[i] > 0 ? (uint8_t) (sums[i] / counts[i]) : 0;
+        }
+
+        // Moyennes de toutes les tuiles, ligne par ligne
+        void getAverages (uint8_t* dest) const
+        {
+            for (size_t i = 0; i < sums.size(); ++i)
+                dest[i] = counts[i] > 0 ? (uint8_t) (sums[i] / counts[i]) : 0;
+        }
+    };
+
+    //==============================================================================
+    // Convertit une ligne de pixels 8 bits par canal en luminance.
+    // weights[i] est le poids de l'octet i de chaque pixel (stride 3 ou 4).
+    inline void lumaRow (const uint8_t* src, int numPixels, int pixelStride,
+                         const uint8_t weights[4], uint8_t* dest)
+    {
+        int x = 0;
+
+        if (pixelStride == 4)
+        {
+           #if BIS_LUMA_AVX2
+            const __m256i w = _mm256_setr_epi16 (weights[0], weights[1], weights[2], weights[3],
+                                                 weights[0], weights[1], weights[2], weights[3],
+                                                 weights[0], weights[1], weights[2], weights[3],
+                                                 weights[0], weights[1], weights[2], weights[3]);
+            const __m256i zero = _mm256_setzero_si256();
+
+            for (; x + 8 <= numPixels; x += 8)
+            {
+                auto px = _mm256_loadu_si256 ((const __m256i*) (src + x * 4));
+                // Dans chaque voie : lo = pixels 0,1 (4,5), hi = pixels 2,3 (6,7)
+                auto lo = _mm256_madd_epi16 (_mm256_unpacklo_epi8 (px, zero), w);
+                auto hi = _mm256_madd_epi16 (_mm256_unpackhi_epi8 (px, zero), w);
+                auto even = _mm256_castps_si256 (_mm256_shuffle_ps (_mm256_castsi256_ps (lo), _mm256_castsi256_ps (hi), _MM_SHUFFLE (2, 0, 2, 0)));
+                auto odd  = _mm256_castps_si256 (_mm256_shuffle_ps (_mm256_castsi256_ps (lo), _mm256_castsi256_ps (hi), _MM_SHUFFLE (3, 1, 3, 1)));
+                auto y = _mm256_srli_epi32 (_mm256_add_epi32 (even, odd), 8);
+                auto y16 = _mm_packs_epi32 (_mm256_castsi256_si128 (y), _mm256_extracti128_si256 (y, 1));
+                _mm_storel_epi64 ((__m128i*) (dest + x), _mm_packus_epi16 (y16, y16));
+            }
+           #elif BIS_LUMA_SSE2
+            const __m128i w = _mm_setr_epi16 (weights[0], weights[1], weights[2], weights[3],
+                                              weights[0], weights[1], weights[2], weights[3]);
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; x + 8 <= numPixels; x += 8)
+            {
+                __m128i y[2];
+
+                for (int half = 0; half < 2; ++half)
+                {
+                    auto px = _mm_loadu_si128 ((const __m128i*) (src + (x + half * 4) * 4));
+                    auto lo = _mm_madd_epi16 (_mm_unpacklo_epi8 (px, zero), w);
+                    auto hi = _mm_madd_epi16 (_mm_unpackhi_epi8 (px, zero), w);
+                    auto even = _mm_castps_si128 (_mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (2, 0, 2, 0)));
+                    auto odd  = _mm_castps_si128 (_mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (3, 1, 3, 1)));
+                    y[half] = _mm_srli_epi32 (_mm_add_epi32 (even, odd), 8);
+                }
+
+                auto y16 = _mm_packs_epi32 (y[0], y[1]);
+                _mm_storel_epi64 ((__m128i*) (dest + x), _mm_packus_epi16 (y16, y16));
+            }
+           #elif BIS_LUMA_NEON
+            const auto w0 = vdup_n_u8 (weights[0]), w1 = vdup_n_u8 (weights[1]);
+            const auto w2 = vdup_n_u8 (weights[2]), w3 = vdup_n_u8 (weights[3]);
+
+            for (; x + 8 <= numPixels; x += 8)
+            {
+                auto px = vld4_u8 (src + x * 4);
+                auto acc = vmull_u8 (px.val[0], w0);
+                acc = vmlal_u8 (acc, px.val[1], w1);
+                acc = vmlal_u8 (acc, px.val[2], w2);
+                acc = vmlal_u8 (acc, px.val[3], w3);
+                vst1_u8 (dest + x, vshrn_n_u16 (acc, 8));
+            }
+           #endif
+        }
+       #if BIS_LUMA_NEON
+        else if (pixelStride == 3)
+        {
+            const auto w0 = vdup_n_u8 (weights[0]), w1 = vdup_n_u8 (weights[1]), w2 = vdup_n_u8 (weights[2]);
+
+            for (; x + 8 <= numPixels; x += 8)
+            {
+                auto px = vld3_u8 (src + x * 3);
+                auto acc = vmull_u8 (px.val[0], w0);
+                acc = vmlal_u8 (acc, px.val[1], w1);
+                acc = vmlal_u8 (acc, px.val[2], w2);
+                vst1_u8 (dest + x, vshrn_n_u16 (acc, 8));
+            }
+        }
+       #endif
+
+        // Fin de ligne (ou format sans chemin vectoriel)
+        for (; x < numPixels; ++x)
+        {
+            auto* p = src + x * pixelStride;
+            dest[x] = (uint8_t) ((p[0] * weights[0] + p[1] * weights[1] + p[2] * weights[2]
+                                  + (pixelStride == 4 ? p[3] * weights[3] : 0)) >> 8);
+        }
+    }
+
+    // Poids par octet selon le format de pixel
+    inline void getWeightsForFormat (juce::Image::PixelFormat format, uint8_t weights[4])
+    {
+        weights[0] = weights[1] = weights[2] = weights[3] = 0;
+
+        if (format == juce::Image::ARGB)
+        {
+            weights[juce::PixelARGB::indexR] = weightR;
+            weights[juce::PixelARGB::indexG] = weightG;
+            weights[juce::PixelARGB::indexB] = weightB;
+        }
+        else if (format == juce::Image::RGB)
+        {
+            weights[juce::PixelRGB::indexR] = weightR;
+            weights[juce::PixelRGB::indexG] = weightG;
+            weights[juce::PixelRGB::indexB] = weightB;
+        }
+    }
+
+    //==============================================================================
+    /**
+        Recadre n'importe quelle résolution de caméra au format de la grille
+        (centré) puis réduit chaque zone source à une tuile en une seule passe.
+
+        Chaque tuile moyenne au plus maxSamplesPerAxis x maxSamplesPerAxis pixels
+        répartis régulièrement dans sa zone : toute la zone si elle est plus
+        petite (moyenne exacte), un sous-échantillonnage sinon. Le coût par
+        tuile est donc borné quelle que soit la caméra (720p, 1080p, 4K...).
+
+        processChanged() ne recalcule que les tuiles qui ont changé depuis la
+        frame précédente, détectées sur une seule ligne échantillonnée par
+        rangée de tuiles et par frame.
+    */
+    class TileResampler
+    {
+    public:
+        TileResampler (int gridWidthToUse, int gridHeightToUse, int maxSamplesPerAxisToUse = 6)
+            : gridWidth (gridWidthToUse), gridHeight (gridHeightToUse), maxSamplesPerAxis (maxSamplesPerAxisToUse)
+        {
+        }
+
+        // Avec withHistogram, l'histogramme de luminance est rempli pendant la même passe.
+        void process (const juce::Image::BitmapData& src, TileSums& out, bool withHistogram = false)
+        {
+            if (src.width != sourceWidth || src.height != sourceHeight)
+                prepare (src.width, src.height);
+
+            const int numSamples = (int) sampleCols.size();
+
+            out.resize (gridWidth, gridHeight, numSamples);
+            out.sourceWidth = sourceWidth;
+            out.sourceHeight = sourceHeight;
+            out.hasHistogram = withHistogram;
+
+            if (withHistogram)
+                std::fill (std::begin (out.histogram), std::end (out.histogram), 0u);
+
+            getWeightsForFormat (src.pixelFormat, weights);
+
+            for (int ty = 0; ty < gridHeight; ++ty)
+            {
+                auto* rowSums = out.sums.data() + ty * gridWidth;
+                std::fill (rowSums, rowSums + gridWidth, 0u);
+
+                const int firstRow = rowOffsets[(size_t) ty];
+                const int numRows = rowOffsets[(size_t) ty + 1] - firstRow;
+
+                for (int r = 0; r < numRows; ++r)
+                {
+                    const auto* luma = loadLumaLine (src, firstRow + r, out.line.data());
+
+                    for (int tx = 0; tx < gridWidth; ++tx)
+                    {
+                        const int x0 = colOffsets[(size_t) tx];
+                        const int x1 = colOffsets[(size_t) tx + 1];
+                        uint32_t sum = 0;
+
+                        if (withHistogram)
+                        {
+                            for (int x = x0; x < x1; ++x)
+                            {
+                                sum += luma[x];
+                                ++out.histogram[luma[x]];
+                            }
+                        }
+                        else
+                        {
+                            for (int x = x0; x < x1; ++x)
+                                sum += luma[x];
+                        }
+
+                        rowSums[tx] += sum;
+                    }
+                }
+
+                setRowCounts (out, ty);
+            }
+
+            // La référence de processChanged() ne correspond plus à out
+            referenceValid = false;
+        }
+
+        //==============================================================================
+        /**
+            Variante incrémentale de process() : out doit contenir le résultat de la
+            frame précédente (même TileSums, d'une frame à l'autre).
+
+            La luminance échantillonnée de chaque tuile est gardée en référence à
+            son dernier recalcul. À chaque frame, une seule des lignes échantillonnées
+            de chaque rangée est comparée à la référence (somme des différences
+            absolues), en changeant de ligne d'une frame à l'autre. Une tuile est sale
+            quand l'écart dépasse changeThreshold niveaux par pixel : seules ses
+            sommes sont refaites, et seules les rangées contenant une tuile sale
+            sont relues en entier.
+
+            dirty reçoit 1 octet par tuile (1 = recalculée). Avec forceFull, toutes
+            les tuiles sont recalculées. Renvoie le nombre de tuiles recalculées.
+        */
+        int processChanged (const juce::Image::BitmapData& src, TileSums& out, std::vector<uint8_t>& dirty,
+                            bool withHistogram = false, bool forceFull = false, int changeThreshold = 6)
+        {
+            if (src.width != sourceWidth || src.height != sourceHeight)
+                prepare (src.width, src.height);
+
+            const int numSamples = (int) sampleCols.size();
+            const int numTiles = gridWidth * gridHeight;
+
+            forceFull = forceFull || ! referenceValid
+                          || out.tilesX != gridWidth || out.tilesY != gridHeight
+                          || out.sourceWidth != sourceWidth || out.sourceHeight != sourceHeight
+                          || (withHistogram && ! rowHistogramsValid);
+
+            out.resize (gridWidth, gridHeight, numSamples);
+            out.sourceWidth = sourceWidth;
+            out.sourceHeight = sourceHeight;
+            out.hasHistogram = withHistogram;
+
+            dirty.assign ((size_t) numTiles, forceFull ? 1 : 0);
+            reference.resize (sampleRows.size() * (size_t) numSamples);
+            rowHistograms.resize ((size_t) (gridHeight * 256));
+            ++detectionPhase;
+
+            getWeightsForFormat (src.pixelFormat, weights);
+            int numDirty = 0;
+
+            for (int ty = 0; ty < gridHeight; ++ty)
+            {
+                const int firstRow = rowOffsets[(size_t) ty];
+                const int numRows = rowOffsets[(size_t) ty + 1] - firstRow;
+                auto* rowDirty = dirty.data() + ty * gridWidth;
+                bool rowChanged = forceFull;
+
+                // Détection sur une ligne de la rangée, décalée d'une rangée à l'autre
+                if (! forceFull)
+                {
+                    const int detectionRow = firstRow + (int) ((detectionPhase + (uint32_t) ty) % (uint32_t) numRows);
+                    const auto* luma = loadLumaLine (src, detectionRow, out.line.data());
+                    const auto* previous = reference.data() + (size_t) detectionRow * (size_t) numSamples;
+
+                    for (int tx = 0; tx < gridWidth; ++tx)
+                    {
+                        const int x0 = colOffsets[(size_t) tx];
+                        const int x1 = colOffsets[(size_t) tx + 1];
+                        int difference = 0;
+
+                        for (int x = x0; x < x1; ++x)
+                            difference += std::abs ((int) luma[x] - (int) previous[x]);
+
+                        if (difference > changeThreshold * (x1 - x0))
+                        {
+                            rowDirty[tx] = 1;
+                            rowChanged = true;
+                        }
+                    }
+                }
+
+                if (! rowChanged)
+                    continue;
+
+                // Recalcul des tuiles sales de la rangée, et de son histogramme
+                auto* rowSums = out.sums.data() + ty * gridWidth;
+                auto* histogram = rowHistograms.data() + ty * 256;
+
+                if (withHistogram)
+                    std::fill (histogram, histogram + 256, (uint16_t) 0);
+
+                for (int tx = 0; tx < gridWidth; ++tx)
+                    if (rowDirty[tx] != 0)
+                        rowSums[tx] = 0;
+
+                for (int r = 0; r < numRows; ++r)
+                {
+                    const auto* luma = loadLumaLine (src, firstRow + r, out.line.data());
+                    auto* previous = reference.data() + (size_t) (firstRow + r) * (size_t) numSamples;
+
+                    if (withHistogram)
+                        for (int x = 0; x < numSamples; ++x)
+                            ++histogram[luma[x]];
+
+                    for (int tx = 0; tx < gridWidth; ++tx)
+                    {
+                        if (rowDirty[tx] == 0)
+                            continue;
+
+                        const int x0 = colOffsets[(size_t) tx];
+                        const int x1 = colOffsets[(size_t) tx + 1];
+                        uint32_t sum = 0;
+
+                        for (int x = x0; x < x1; ++x)
+                            sum += luma[x];
+
+                        rowSums[tx] += sum;
+                        std::memcpy (previous + x0, luma + x0, (size_t) (x1 - x0));
+                    }
+                }
+
+                for (int tx = 0; tx < gridWidth; ++tx)
+                    numDirty += rowDirty[tx];
+
+                setRowCounts (out, ty);
+            }
+
+            if (withHistogram)
+            {
+                std::fill (std::begin (out.histogram), std::end (out.histogram), 0u);
+
+                for (int ty = 0; ty < gridHeight; ++ty)
+                {
+                    const auto* histogram = rowHistograms.data() + ty * 256;
+
+                    for (int i = 0; i < 256; ++i)
+                        out.histogram[i] += histogram[i];
+                }
+            }
+
+            referenceValid = true;
+            rowHistogramsValid = withHistogram;
+            return numDirty;
+        }
+
+    private:
+        // Luminance des colonnes échantillonnées d'une ligne échantillonnée
+        const uint8_t* loadLumaLine (const juce::Image::BitmapData& src, int sampleRowIndex, uint8_t* luma)
+        {
+            const int numSamples = (int) sampleCols.size();
+            const int stride = src.pixelStride;
+            const uint8_t* line = src.getLinePointer (sampleRows[(size_t) sampleRowIndex]);
+
+            // Les colonnes échantillonnées sont contiguës tant que la zone d'une
+            // tuile ne dépasse pas maxSamplesPerAxis : pas besoin de les regrouper
+            const uint8_t* pixels = line + cropX * stride;
+
+            if (! contiguous)
+            {
+                gathered.resize ((size_t) (numSamples * stride));
+
+                for (int i = 0; i < numSamples; ++i)
+                    std::memcpy (gathered.data() + i * stride, line + sampleCols[(size_t) i] * stride, (size_t) stride);
+
+                pixels = gathered.data();
+            }
+
+            if (src.pixelFormat == juce::Image::SingleChannel)
+                std::memcpy (luma, pixels, (size_t) numSamples);
+            else
+                lumaRow (pixels, numSamples, stride, weights, luma);
+
+            return luma;
+        }
+
+        void setRowCounts (TileSums& out, int ty) const
+        {
+            const int numRows = rowOffsets[(size_t) ty + 1] - rowOffsets[(size_t) ty];
+            auto* rowCounts = out.counts.data() + ty * gridWidth;
+
+            for (int tx = 0; tx < gridWidth; ++tx)
+                rowCounts[tx] = (uint16_t) ((colOffsets[(size_t) tx + 1] - colOffsets[(size_t) tx]) * numRows);
+        }
+
+        // Calcule le recadrage et les pixels échantillonnés pour une taille de caméra
+        void prepare (int newSourceWidth, int newSourceHeight)
+        {
+            sourceWidth = newSourceWidth;
+            sourceHeight = newSourceHeight;
+
+            // Recadrage centré au format de la grille
+            int cropW = sourceWidth, cropH = sourceHeight;
+
+            if ((int64_t) sourceWidth * gridHeight > (int64_t) sourceHeight * gridWidth)
+                cropW = (int) ((int64_t) sourceHeight * gridWidth / gridHeight);
+            else
+                cropH = (int) ((int64_t) sourceWidth * gridHeight / gridWidth);
+
+            cropX = (sourceWidth - cropW) / 2;
+            referenceValid = false;
+            const int cropY = (sourceHeight - cropH) / 2;
+
+            buildAxis (cropX, cropW, gridWidth, sampleCols, colOffsets);
+            buildAxis (cropY, cropH, gridHeight, sampleRows, rowOffsets);
+
+            contiguous = true;
+            for (size_t i = 0; i < sampleCols.size(); ++i)
+                contiguous = contiguous && sampleCols[i] == cropX + (int) i;
+        }
+
+        void buildAxis (int start, int length, int numTiles, std::vector<int>& samples, std::vector<int>& offsets)
+        {
+            samples.clear();
+            offsets.assign ((size_t) numTiles + 1, 0);
+
+            for (int t = 0; t < numTiles; ++t)
+            {
+                offsets[(size_t) t] = (int) samples.size();
+
+                const int a = (int) ((int64_t) t * length / numTiles);
+                const int b = juce::jmax (a + 1, (int) ((int64_t) (t + 1) * length / numTiles));
+                const int span = b - a;
+
+                if (span <= maxSamplesPerAxis)
+                {
+                    for (int i = a; i < b; ++i)
+                        samples.push_back (start + juce::jmin (i, length - 1));
+                }
+                else
+                {
+                    for (int i = 0; i < maxSamplesPerAxis; ++i)
+                        samples.push_back (start + a + (2 * i + 1) * span / (2 * maxSamplesPerAxis));
+                }
+            }
+
+            offsets[(size_t) numTiles] = (int) samples.size();
+        }
+
+        const int gridWidth;
+        const int gridHeight;
+        const int maxSamplesPerAxis;
+
+        int sourceWidth = -1;
+        int sourceHeight = -1;
+        int cropX = 0;
+        bool contiguous = true;
+
+        std::vector<int> sampleCols, colOffsets;
+        std::vector<int> sampleRows, rowOffsets;
+        std::vector<uint8_t> gathered;
+        uint8_t weights[4] = {};
+
+        // État de processChanged() : luminance échantillonnée de chaque tuile à son
+        // dernier recalcul, et histogramme de chaque rangée de tuiles
+        std::vector<uint8_t> reference;
+        std::vector<uint16_t> rowHistograms;
+        uint32_t detectionPhase = 0;
+        bool referenceValid = false;
+        bool rowHistogramsValid = false;
+    };
+
+    //==============================================================================
+    // Seuil d'Otsu : maximise la variance inter-classes de l'histogramme
+    inline int computeOtsuThreshold (const uint32_t histogram[256])
+    {
+        uint64_t total = 0, sumAll = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            total += histogram[i];
+            sumAll += (uint64_t) i * histogram[i];
+        }
+
+        if (total == 0)
+            return 127;
+
+        uint64_t weightBack = 0, sumBack = 0;
+        double bestVariance = -1.0;
+        int best = 127;
+
+        for (int t = 0; t < 256; ++t)
+        {
+            weightBack += histogram[t];
+            if (weightBack == 0)
+                continue;
+
+            auto weightFore = total - weightBack;
+            if (weightFore == 0)
+                break;
+
+            sumBack += (uint64_t) t * histogram[t];
+            auto meanBack = (double) sumBack / (double) weightBack;
+            auto meanFore = (double) (sumAll - sumBack) / (double) weightFore;
+            auto variance = (double) weightBack * (double) weightFore * (meanBack - meanFore) * (meanBack - meanFore);
+
+            if (variance > bestVariance)
+            {
+                bestVariance = variance;
+                best = t;
+            }
+        }
+
+        // Les pixels <= best forment la classe sombre : on noircit en dessous de best + 1
+        return best + 1;
+    }
+
+    // Chemin scalaire d'origine (getPixelColour + flottants), gardé comme référence
+    inline void computeTileSumsScalar (const juce::Image::BitmapData& src, int tileSize, TileSums& out)
+    {
+        const int w = src.width;
+        const int h = src.height;
+
+        out.resize ((w + tileSize - 1) / tileSize, (h + tileSize - 1) / tileSize, w);
+        out.sourceWidth = w;
+        out.sourceHeight = h;
+
+        for (int ty = 0; ty < out.tilesY; ++ty)
+        {
+            for (int tx = 0; tx < out.tilesX; ++tx)
+            {
+                uint32_t sum = 0;
+                uint16_t count = 0;
+
+                for (int y = ty * tileSize; y < (ty + 1) * tileSize && y < h; ++y)
+                {
+                    for (int x = tx * tileSize; x < (tx + 1) * tileSize && x < w; ++x)
+                    {
+                        auto c = src.getPixelColour (x, y);
+                        sum += static_cast<uint8_t> (0.299f * c.getRed()
+                                                     + 0.587f * c.getGreen()
+                                                     + 0.114f * c.getBlue());
+                        ++count;
+                    }
+                }
+
+                auto i = (size_t) (ty * out.tilesX + tx);
+                out.sums[i] = sum;
+                out.counts[i] = count;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Frame synthétique (dégradé bruité) pour les benchmarks
+    inline juce::Image makeBenchmarkFrame (juce::Image::PixelFormat format, int width, int height)
+    {
+        juce::Image frame (format, width, height, false);
+        juce::Random rng (1234);
+        juce::Image::BitmapData data (frame, juce::Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* line = data.getLinePointer (y);
+
+            for (int x = 0; x < width * data.pixelStride; ++x)
+                line[x] = (uint8_t) ((x + y) / 8 + rng.nextInt (32));
+
+            if (format == juce::Image::ARGB)
+                for (int x = 0; x < width; ++x)
+                    line[x * 4 + juce::PixelARGB::indexA] = 255;
+        }
+
+        return frame;
+    }
+
+    // Compare le noyau vectorisé au chemin scalaire sur des frames synthétiques,
+    // puis mesure le rééchantillonnage vers la grille 320 x 180 selon la caméra
+    inline juce::String runBenchmark (int width = 1920, int height = 1080, int tileSize = 6, int iterations = 20)
+    {
+        juce::String report ("Luma kernel benchmark (" + juce::String (width) + "x" + juce::String (height)
+                             + ", tile " + juce::String (tileSize) + ")");
+
+        for (auto format : { juce::Image::ARGB, juce::Image::RGB })
+        {
+            auto frame = makeBenchmarkFrame (format, width, height);
+            juce::Image::BitmapData src (frame, juce::Image::BitmapData::readOnly);
+            TileSums scalar, vectorised;
+            TileResampler resampler (width / tileSize, height / tileSize, tileSize);
+
+            auto start = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < iterations; ++i)
+                computeTileSumsScalar (src, tileSize, scalar);
+            auto scalarMs = (juce::Time::getMillisecondCounterHiRes() - start) / iterations;
+
+            start = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < iterations; ++i)
+                resampler.process (src, vectorised);
+            auto vectorMs = (juce::Time::getMillisecondCounterHiRes() - start) / iterations;
+
+            int maxDiff = 0;
+            for (int ty = 0; ty < vectorised.tilesY; ++ty)
+                for (int tx = 0; tx < vectorised.tilesX; ++tx)
+                    maxDiff = juce::jmax (maxDiff, std::abs ((int) scalar.getAverage (tx, ty) - (int) vectorised.getAverage (tx, ty)));
+
+            report << "\n  " << (format == juce::Image::ARGB ? "ARGB" : "RGB ")
+                   << " scalar: " << juce::String (scalarMs, 2) << " ms"
+                   << ", vector: " << juce::String (vectorMs, 2) << " ms"
+                   << " (x" << juce::String (scalarMs / juce::jmax (vectorMs, 0.001), 1) << ")"
+                   << ", max avg diff: " << maxDiff;
+        }
+
+        const int resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 }, { 640, 480 } };
+
+        for (auto& res : resolutions)
+        {
+            auto frame = makeBenchmarkFrame (juce::Image::ARGB, res[0], res[1]);
+            juce::Image::BitmapData src (frame, juce::Image::BitmapData::readOnly);
+            TileSums sums;
+            TileResampler resampler (320, 180);
+
+            auto start = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < iterations; ++i)
+                resampler.process (src, sums);
+            auto ms = (juce::Time::getMillisecondCounterHiRes() - start) / iterations;
+
+            report << "\n  resample " << res[0] << "x" << res[1] << " -> 320x180: " << juce::String (ms, 2) << " ms";
+        }
+
+        return report;
+    }
+}
@@ -8,6 +8,9 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "PrintBitmapTests.h"
+#include "PrinterSysExTests.h"
+#include <iostream>
 
 //==============================================================================
 class BISPlayerApplication  : public juce::JUCEApplication
@@ -25,6 +28,22 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Mode sans fenêtre : --benchmark [--frames=... --fps=... --size=...]
+        if (getCommandLineParameterArray().contains ("--benchmark"))
+        {
+            runHeadlessBenchmark();
+            quit();
+            return;
+        }
+
+        // Tests unitaires sans fenêtre : --test, code de retour 1 en cas d'échec
+        if (getCommandLineParameterArray().contains ("--test"))
+        {
+            setApplicationReturnValue (runUnitTests() ? 0 : 1);
+            quit();
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -50,6 +69,42 @@ public:
         // the other instance's command-line arguments were.
     }
 
+    // Benchmarks du pipeline image sans caméra ni interface, résultats sur la sortie standard
+    void runHeadlessBenchmark()
+    {
+        std::cout << LumaKernel::runBenchmark() << std::endl;
+        std::cout << Quantizer::runBenchmark() << std::endl;
+
+        auto source = FrameSource::createFromCommandLine (getCommandLineParameterArray());
+        auto* timed = dynamic_cast<TimedFrameSource*> (source.get());
+
+        if (timed == nullptr)
+        {
+            source = std::make_unique<SyntheticFrameSource> (1920, 1080, 30.0, SyntheticFrameSource::Pattern::movingShapes);
+            timed = static_cast<TimedFrameSource*> (source.get());
+        }
+
+        std::cout << CameraCapture::runPipelineBenchmark (*timed, 300) << std::endl;
+    }
+
+    // Renvoie false si au moins un test a échoué
+    bool runUnitTests()
+    {
+        PrintBitmapTests printBitmapTests;
+        PrinterSysExTests printerSysExTests;
+
+        juce::UnitTestRunner runner;
+        runner.setAssertOnFailure (false);
+        runner.runTests ({ &printBitmapTests, &printerSysExTests });
+
+        int failures = 0;
+
+        for (int i = 0; i < runner.getNumResults(); ++i)
+            failures += runner.getResult (i)->failures;
+
+        return failures == 0;
+    }
+
     //==============================================================================
     /*
         This class implements the desktop window that contains an instance of
@@ -15,17 +15,8 @@ MainComponent::MainComponent()
 {
     
     // Créer le logger personnalisé
-    componentLogger = std::make_unique<ComponentLogger> (&logTextEditor);
+    componentLogger = std::make_unique<ComponentLogger> (&logView);
     juce::Logger::setCurrentLogger (componentLogger.get());
-
-    // Configurer le TextEditor pour les logs
-    logTextEditor.setMultiLine (true);
-    logTextEditor.setReturnKeyStartsNewLine (true);
-    logTextEditor.setReadOnly (true);
-    logTextEditor.setCaretVisible (false);
-    logTextEditor.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
-    logTextEditor.setColour (juce::TextEditor::backgroundColourId, juce::Colours::black);
-    logTextEditor.setColour (juce::TextEditor::textColourId, juce::Colours::lightgreen);
     
     // Configurer le slider pour le threshold
     thresholdSlider.setRange (0.0, 1.0, 0.01);
@@ -37,6 +28,26 @@ MainComponent::MainComponent()
     thresholdLabel.attachToComponent (&thresholdSlider, true);
     thresholdLabel.setColour (juce::Label::textColourId, juce::Colours::white);
     
+    // Bouton pour le seuil automatique (Otsu)
+    autoThresholdButton.setButtonText ("Auto");
+    autoThresholdButton.setColour (juce::ToggleButton::textColourId, juce::Colours::white);
+    autoThresholdButton.onClick = [this]()
+    {
+        bool isAuto = autoThresholdButton.getToggleState();
+        capture->setAutoThreshold (isAuto);
+        thresholdSlider.setEnabled (! isAuto);
+        juce::Logger::writeToLog (juce::String ("Auto threshold ") + (isAuto ? "on" : "off"));
+    };
+    
+    // Configurer la ComboBox du mode de tramage
+    ditherComboBox.addItemList (Quantizer::getModeNames(), 1);
+    ditherComboBox.setSelectedId (1, juce::dontSendNotification);
+    ditherComboBox.addListener (this);
+    
+    ditherLabel.setText ("Dithering:", juce::dontSendNotification);
+    ditherLabel.attachToComponent (&ditherComboBox, true);
+    ditherLabel.setColour (juce::Label::textColourId, juce::Colours::white);
+    
     // Configurer les labels pour les ComboBox
     midiInputLabel.setText ("MIDI Input:", juce::dontSendNotification);
     midiInputLabel.attachToComponent (&midiInputComboBox, true);
@@ -51,10 +62,11 @@ MainComponent::MainComponent()
     midiManager->setupComboBoxes (&midiInputComboBox, &midiOutputComboBox, 
                                    &midiInputLabel, &midiOutputLabel);
     
-    // Configurer le callback pour les messages MIDI entrants
-    midiManager->onMidiMessageReceived = [this](juce::MidiInput* source, const juce::MidiMessage& message)
+    // Les messages MIDI entrants sont mis en file sur le thread du pilote,
+    // puis traités dans l'ordre par timerCallback()
+    midiManager->onMidiMessageReceived = [this](juce::MidiInput*, const juce::MidiMessage& message)
     {
-        handleIncomingMidiMessage (source, message);
+        midiEvents.push (message);
     };
     
     capture = std::make_unique<CameraCapture>(midiManager.get());
@@ -65,10 +77,61 @@ MainComponent::MainComponent()
         midiManager->sendProgramChange(16, 71);
     };
     
+    // Débit du flux de l'imprimante (--printer-rate=<octets/s>, 3000 par défaut),
+    // transport SysEx (--printer-transport=sysex), compression (--printer-compression),
+    // contrôle de flux par acquittement des bandes (--printer-ack)
+    // et imprimante simulée, branchée sur MidiManager (--printer-simulator) ou sur
+    // un port MIDI virtuel (--printer-simulator=port)
+    for (auto& arg : juce::JUCEApplicationBase::getCommandLineParameterArray())
+    {
+        if (arg.startsWith ("--printer-rate="))
+            midiManager->setPrinterByteRate (arg.fromFirstOccurrenceOf ("=", false, false).getDoubleValue());
+        
+        if (arg == "--printer-transport=sysex")
+            midiManager->setPrinterTransport (MidiManager::PrinterTransport::sysex);
+        
+        if (arg == "--printer-compression")
+            midiManager->setPrinterCompression (true);
+        
+        if (arg == "--printer-ack")
+            midiManager->setPrinterFlowControl (true);
+        
+        if (arg.startsWith ("--printer-simulator"))
+        {
+            auto desktop = juce::File::getSpecialLocation (juce::File::userDesktopDirectory);
+            printerSimulator = std::make_unique<PrinterSimulator> (desktop.getChildFile ("printer_simulated.png"));
+            
+            if (arg == "--printer-simulator=port")
+                printerSimulator->openVirtualPort();
+            else
+            {
+                midiManager->setOutputMonitor ([sim = printerSimulator.get()] (const juce::MidiMessage& m) { sim->process (m); });
+                printerSimulator->onReply = [mm = midiManager.get()] (const juce::MidiMessage& m)
+                {
+                    // Les réponses ne vont qu'aux acquittements : la file des événements
+                    // du spectacle n'a qu'un producteur, l'entrée MIDI
+                    if (m.isController() && m.getControllerNumber() == MidiManager::printerAckController)
+                        mm->handlePrinterAck (m.getControllerValue());
+                };
+            }
+        }
+    }
+    
+    // Le simulateur n'acquitte les bandes que si le contrôle de flux les attend
+    if (printerSimulator != nullptr)
+        printerSimulator->setAcknowledgeBands (midiManager->getPrinterFlowControl());
+    
+    // Source d'images alternative passée en ligne de commande (--frames=...)
+    if (auto source = FrameSource::createFromCommandLine (juce::JUCEApplicationBase::getCommandLineParameterArray()))
+        capture->setFrameSource (std::move (source));
+    
     addAndMakeVisible (videoComponent);
-    addAndMakeVisible (logTextEditor);
+    addAndMakeVisible (logView);
     addAndMakeVisible (thresholdSlider);
     addAndMakeVisible (thresholdLabel);
+    addAndMakeVisible (autoThresholdButton);
+    addAndMakeVisible (ditherComboBox);
+    addAndMakeVisible (ditherLabel);
     addAndMakeVisible (midiInputComboBox);
     addAndMakeVisible (midiOutputComboBox);
     addAndMakeVisible (midiInputLabel);
@@ -118,6 +181,9 @@ MainComponent::~MainComponent()
     // Arrêter le timer
     stopTimer();
     
+    // Les benchmarks écrivent dans le logger et la vue : on attend leur fin
+    benchmarkPool.removeAllJobs (true, 60000);
+    
     // Nettoyer les callbacks du VideoComponent pour éviter les appels après destruction
     /*videoComponent.onPlaybackStopped = nullptr;
     videoComponent.onPlaybackStarted = nullptr;*/
@@ -125,6 +191,9 @@ MainComponent::~MainComponent()
     // Désenregistrer le logger avant de le détruire
     juce::Logger::setCurrentLogger (nullptr);
     
+    // Arrêter la caméra et la file d'impression, qui envoie encore du MIDI
+    capture.reset();
+    
     // Fermer le gestionnaire MIDI (qui fermera les périphériques)
     midiManager.reset();
     
@@ -232,13 +301,19 @@ void MainComponent::resized()
         const int labelWidth = 100;
         const int spacing = 5;
         
-        auto controlsArea = rightArea.removeFromTop (controlHeight * 3 + spacing * 2);
+        auto controlsArea = rightArea.removeFromTop (controlHeight * 4 + spacing * 3);
         
         // Positionner le slider threshold en premier
         auto thresholdArea = controlsArea.removeFromTop (controlHeight);
         thresholdLabel.setBounds (thresholdArea.removeFromLeft (labelWidth));
+        autoThresholdButton.setBounds (thresholdArea.removeFromRight (70));
         thresholdSlider.setBounds (thresholdArea);
         
+        controlsArea.removeFromTop (spacing);
+        auto ditherArea = controlsArea.removeFromTop (controlHeight);
+        ditherLabel.setBounds (ditherArea.removeFromLeft (labelWidth));
+        ditherComboBox.setBounds (ditherArea);
+        
         controlsArea.removeFromTop (spacing);
         
         // Positionner les ComboBox
@@ -252,16 +327,19 @@ void MainComponent::resized()
         midiOutputComboBox.setBounds (outputArea);
         
         // Le TextEditor prend le reste de l'espace en bas
-        logTextEditor.setBounds (rightArea);
+        logView.setBounds (rightArea);
     }
     else
     {
         // Le lecteur vidéo prend toute la taille du composant
         videoComponent.setBounds (bounds);
         capture->setBounds(bounds);
-        logTextEditor.setBounds (0, 0, 0, 0);  // Caché
+        logView.setBounds (0, 0, 0, 0);  // Caché
         thresholdSlider.setBounds (0, 0, 0, 0);  // Caché
         thresholdLabel.setBounds (0, 0, 0, 0);  // Caché
+        autoThresholdButton.setBounds (0, 0, 0, 0);  // Caché
+        ditherComboBox.setBounds (0, 0, 0, 0);  // Caché
+        ditherLabel.setBounds (0, 0, 0, 0);  // Caché
         midiInputComboBox.setBounds (0, 0, 0, 0);  // Caché
         midiOutputComboBox.setBounds (0, 0, 0, 0);  // Caché
         midiInputLabel.setBounds (0, 0, 0, 0);  // Caché
@@ -271,9 +349,12 @@ void MainComponent::resized()
 
 void MainComponent::updateLoggerVisibility() {
     
-    logTextEditor.setVisible (isLoggerVisible);
+    logView.setVisible (isLoggerVisible);
     thresholdSlider.setVisible (isLoggerVisible);
     thresholdLabel.setVisible (isLoggerVisible);
+    autoThresholdButton.setVisible (isLoggerVisible);
+    ditherComboBox.setVisible (isLoggerVisible);
+    ditherLabel.setVisible (isLoggerVisible);
     midiInputComboBox.setVisible (isLoggerVisible);
     midiOutputComboBox.setVisible (isLoggerVisible);
     midiInputLabel.setVisible (isLoggerVisible);
@@ -287,9 +368,57 @@ bool MainComponent::keyPressed (const juce::KeyPress& key)
     {
         isLoggerVisible = !isLoggerVisible;
         updateLoggerVisibility();
+        
+        // Latences du pipeline caméra affichées à l'ouverture du panneau
+        if (isLoggerVisible)
+            juce::Logger::writeToLog (capture->getLatencyReport());
         resized();  // Recalculer le layout
         return true;  // Consommer l'événement
     }
+
+    // Benchmarks du pipeline image avec la touche B (logger visible uniquement),
+    // un seul à la fois
+    if (isLoggerVisible && (key.getTextCharacter() == 'b' || key.getTextCharacter() == 'B'))
+    {
+        if (benchmarkPool.getNumJobs() > 0)
+        {
+            juce::Logger::writeToLog ("Benchmarks already running");
+            return true;
+        }
+        
+        benchmarkPool.addJob ([]
+        {
+            juce::Logger::writeToLog (LumaKernel::runBenchmark());
+            juce::Logger::writeToLog (Quantizer::runBenchmark());
+            
+            SyntheticFrameSource source (1920, 1080, 30.0, SyntheticFrameSource::Pattern::movingShapes);
+            juce::Logger::writeToLog (CameraCapture::runPipelineBenchmark (source));
+            juce::Logger::writeToLog (MidiEventQueue::runStressTest());
+        });
+        return true;
+    }
+
+    // Compteurs et latences du pipeline caméra et de la sortie MIDI avec la touche S
+    // (Maj+S : remise à zéro des latences)
+    if (isLoggerVisible && (key.getTextCharacter() == 's' || key.getTextCharacter() == 'S'))
+    {
+        juce::Logger::writeToLog (capture->getPipelineStats());
+        juce::Logger::writeToLog (capture->getLatencyReport());
+        juce::Logger::writeToLog (midiManager->getOutputReport());
+        
+        if (key.getModifiers().isShiftDown())
+        {
+            capture->resetLatencyStats();
+            juce::Logger::writeToLog ("Latency stats reset");
+        }
+        return true;
+    }
+    // Annuler l'impression en cours avec Échap (logger visible uniquement)
+    if (isLoggerVisible && key == juce::KeyPress::escapeKey)
+    {
+        capture->cancelPrint();
+        return true;
+    }
     return false;  // Laisser passer les autres touches
 }
 
@@ -334,31 +463,21 @@ void MainComponent::stopAndHideVideo() {
     capture->setVisible(true);
 }
 
-void MainComponent::handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message)
+void MainComponent::handleMidiEvent (const MidiEventQueue::Event& event)
 {
-    juce::String sourceName = "Unknown";
-    if (source != nullptr)
-    {
-        auto deviceInfo = source->getDeviceInfo();
-        sourceName = deviceInfo.name.isNotEmpty() ? deviceInfo.name : "Unknown";
-    }
-    juce::String logMessage;
+    const auto message = event.toMessage();
+    auto& eventLog = midiManager->getEventLog();
+    
+    // Journaliser les notes et changements de programme entrants, avec leur heure d'arrivée
+    if (message.isNoteOnOrOff() || message.isProgramChange())
+        eventLog.addMidi (EventLog::Type::midiIn, message, event.timeMs);
     
-    // Logger tous les types de messages MIDI entrants
     if (message.isNoteOn())
     {
         const int noteNumber = message.getNoteNumber();
-        const int velocity = message.getVelocity();
-        const int channel = message.getChannel();
-        
-        logMessage = "MIDI IN [" + sourceName + "] Note On - Channel: " + juce::String (channel) + 
-                     ", Note: " + juce::String (noteNumber) + 
-                     ", Velocity: " + juce::String (velocity);
         
-        juce::Logger::writeToLog (logMessage);
-        
-        // Vérifier si au moins 1 seconde s'est écoulée depuis le dernier Note On
-        double currentTime = juce::Time::getMillisecondCounterHiRes();
+        // Vérifier si au moins 1 seconde s'est écoulée depuis le dernier Note On (heures d'arrivée)
+        double currentTime = event.timeMs;
         double timeSinceLastNoteOn = currentTime - lastNoteOnTime;
         
         if (timeSinceLastNoteOn >= NOTE_ON_THROTTLE_MS)
@@ -372,34 +491,10 @@ void MainComponent::handleIncomingMidiMessage (juce::MidiInput* source, const ju
         else
         {
             // Note On ignoré car trop proche du précédent
-            juce::Logger::writeToLog ("Note On throttled (ignored) - " + juce::String (timeSinceLastNoteOn) + "ms since last");
+            eventLog.add (EventLog::Type::noteThrottled, 0, (uint8_t) noteNumber, 0, (float) timeSinceLastNoteOn);
         }
         
     }
-    else if (message.isNoteOff())
-    {
-        const int noteNumber = message.getNoteNumber();
-        const int velocity = message.getVelocity();
-        const int channel = message.getChannel();
-        
-        logMessage = "MIDI IN [" + sourceName + "] Note Off - Channel: " + juce::String (channel) + 
-                     ", Note: " + juce::String (noteNumber) + 
-                     ", Velocity: " + juce::String (velocity);
-        
-        
-        juce::Logger::writeToLog (logMessage);
-    }
-    else if (message.isProgramChange())
-    {
-        const int programNumber = message.getProgramChangeNumber();
-        const int channel = message.getChannel();
-        
-        logMessage = "MIDI IN [" + sourceName + "] Program Change - Channel: " + juce::String (channel) + 
-                     ", Program: " + juce::String (programNumber);
-    
-        
-        juce::Logger::writeToLog (logMessage);
-    }
     else if (message.isController())
     {
         const int controllerNumber = message.getControllerNumber();
@@ -413,13 +508,6 @@ void MainComponent::handleIncomingMidiMessage (juce::MidiInput* source, const ju
                 ledStateChanged = true;
             }
         }
-        /*
-        logMessage = "MIDI IN [" + sourceName + "] Control Change - Channel: " + juce::String (channel) +
-                     ", CC: " + juce::String (controllerNumber) + 
-                     ", Value: " + juce::String (controllerValue);
-        
-        juce::Logger::writeToLog (logMessage);
-         */
     }
 }
 
@@ -457,9 +545,12 @@ void MainComponent::sliderValueChanged (juce::Slider* slider)
 
 void MainComponent::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
 {
-    // Les ComboBox MIDI sont maintenant gérées par MidiManager
-    // Cette méthode est conservée pour compatibilité mais ne fait rien
-    // (le thresholdSlider n'utilise pas de ComboBox)
+    // Les ComboBox MIDI sont gérées par MidiManager ; seule la ComboBox
+    // du mode de tramage est traitée ici
+    if (comboBoxThatHasChanged == &ditherComboBox)
+    {
+        capture->setQuantizerMode ((Quantizer::Mode) (ditherComboBox.getSelectedId() - 1));
+    }
 }
 
 
@@ -497,10 +588,23 @@ void MainComponent::sendControlChange (int channel, int controllerNumber, int co
 
 void MainComponent::timerCallback()
 {
+    // Afficher la valeur du seuil automatique sur le slider
+    if (autoThresholdButton.getToggleState())
+        thresholdSlider.setValue (capture->getAutoThresholdValue(), juce::dontSendNotification);
+    
+    if (int dropped = midiEvents.getAndResetNumDropped())
+        juce::Logger::writeToLog ("MIDI IN queue full: " + juce::String (dropped) + " message(s) dropped");
+    
     if (videoIsloading) {
         return;
     }
     
+    // Messages en file, dans l'ordre ; on s'arrête au premier changement de programme,
+    // les suivants attendent le prochain tick
+    MidiEventQueue::Event event;
+    while (newProgram < 0 && midiEvents.pop (event))
+        handleMidiEvent (event);
+    
     if (ledStateChanged) {
         sendNoteOn(10, MIN_LED+3, ledState, false);
         ledStateChanged = false;
@@ -512,6 +616,7 @@ void MainComponent::timerCallback()
         {*/
             if (newProgram >= FIRST_NOTE && newProgram < (programs.size() + FIRST_NOTE)) {
                 loadProgram(&programs[newProgram - FIRST_NOTE]);
+                midiManager->getEventLog().add (EventLog::Type::programLoaded, 0, (uint8_t) newProgram);
             } else {
                 
             }
@@ -5,6 +5,8 @@
 #include "Program.h"
 #include "CameraCapture.h"
 #include "MidiManager.h"
+#include "PrinterSimulator.h"
+#include "MidiEventQueue.h"
 
 #define FIRST_NOTE 36
 
@@ -49,10 +51,10 @@ private:
     void loadProgram(Program* pgm);
     void loadVideoFile (const juce::URL& videoURL);
     
-    // Gestion des messages MIDI entrants (appelée par MidiManager)
-    void handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message);
+    // Traitement d'un message MIDI entrant sorti de la file (thread message)
+    void handleMidiEvent (const MidiEventQueue::Event& event);
     
-    // ComboBox::Listener (pour le thresholdSlider uniquement)
+    // ComboBox::Listener (pour le mode de tramage)
     void comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged) override;
     
     // Slider::Listener
@@ -74,12 +76,17 @@ private:
     juce::VideoComponent videoComponent;
     std::unique_ptr<CameraCapture> capture;
     
-    // TextEditor pour afficher les logs
-    juce::TextEditor logTextEditor;
+    // Vue pour afficher les logs
+    LogView logView;
     
     // Slider pour contrôler le threshold de la caméra
     juce::Slider thresholdSlider;
     juce::Label thresholdLabel;
+    juce::ToggleButton autoThresholdButton;
+    
+    // ComboBox pour choisir le mode de tramage de la caméra
+    juce::ComboBox ditherComboBox;
+    juce::Label ditherLabel;
     
     // ComboBox pour sélectionner les périphériques MIDI
     juce::ComboBox midiInputComboBox;
@@ -93,6 +100,15 @@ private:
     // Gestionnaire MIDI
     std::unique_ptr<MidiManager> midiManager;
     
+    // Messages MIDI entrants, du thread du pilote vers timerCallback()
+    MidiEventQueue midiEvents;
+    
+    // Imprimante simulée (--printer-simulator)
+    std::unique_ptr<PrinterSimulator> printerSimulator;
+    
+    // Benchmarks de la touche B, attendus par le destructeur
+    juce::ThreadPool benchmarkPool { 1 };
+    
     // État de visibilité du logger
     bool isLoggerVisible = false;
     
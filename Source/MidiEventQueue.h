@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    MidiEventQueue.h
+    File sans verrou (un producteur, un consommateur) des messages MIDI
+    entrants, horodatés à l'arrivée.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "LatencyHistogram.h"
+
+//==============================================================================
+/**
+    Le thread du pilote MIDI appelle push() : copie de 3 octets au plus et d'un
+    horodatage dans un tableau circulaire (juce::AbstractFifo), sans allocation
+    ni verrou. Si la file est pleine, le message est compté comme perdu plutôt
+    que d'attendre.
+
+    Le consommateur (timer du thread message) appelle pop() et traite chaque
+    message dans l'ordre d'arrivée, avec son heure d'arrivée.
+
+    Les messages de plus de 3 octets (SysEx) ne sont pas mis en file : ils sont
+    comptés avec les messages perdus.
+*/
+class MidiEventQueue
+{
+public:
+    struct Event
+    {
+        double timeMs = 0.0;    // Time::getMillisecondCounterHiRes() à l'arrivée
+        uint8_t data[3] = {};
+        uint8_t size = 0;
+
+        juce::MidiMessage toMessage() const     { return juce::MidiMessage (data, size, timeMs / 1000.0); }
+    };
+
+    explicit MidiEventQueue (int capacity = 1024)
+        : fifo (capacity), events ((size_t) capacity)
+    {
+    }
+
+    //==============================================================================
+    // Producteur uniquement ; renvoie false si le message n'a pas été mis en file
+    bool push (const juce::MidiMessage& message) noexcept
+    {
+        const int size = message.getRawDataSize();
+
+        if (size > 3)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        const auto scope = fifo.write (1);
+
+        if (scope.blockSize1 == 0)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        auto& event = events[(size_t) scope.startIndex1];
+        event.timeMs = juce::Time::getMillisecondCounterHiRes();
+        event.size = (uint8_t) size;
+        std::memcpy (event.data, message.getRawData(), (size_t) size);
+        return true;
+    }
+
+    // Consommateur uniquement
+    bool pop (Event& event) noexcept
+    {
+        const auto scope = fifo.read (1);
+
+        if (scope.blockSize1 == 0)
+            return false;
+
+        event = events[(size_t) scope.startIndex1];
+        return true;
+    }
+
+    int getNumReady() const noexcept                { return fifo.getNumReady(); }
+    int getCapacity() const noexcept                { return fifo.getTotalSize() - 1; }
+
+    // Messages perdus depuis le dernier appel
+    int getAndResetNumDropped() noexcept            { return numDropped.exchange (0); }
+
+    //==============================================================================
+    // Inonde une file depuis un port MIDI virtuel bouclé (ou un thread si les
+    // ports virtuels ne sont pas disponibles) et vérifie l'ordre et les pertes
+    static juce::String runStressTest (int numEvents = 100000);
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<Event> events;
+    std::atomic<int> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiEventQueue)
+};
+
+//==============================================================================
+inline juce::String MidiEventQueue::runStressTest (int numEvents)
+{
+    MidiEventQueue queue (1024);
+
+    // Le numéro de chaque message est porté par ses 3 octets (18 bits)
+    auto makeMessage = [] (int i)
+    {
+        return juce::MidiMessage ((uint8_t) (0x90 | ((i >> 14) & 15)), (uint8_t) ((i >> 7) & 127), (uint8_t) (i & 127));
+    };
+
+    auto sequenceOf = [] (const Event& e)
+    {
+        return ((e.data[0] & 15) << 14) | (e.data[1] << 7) | e.data[2];
+    };
+
+    // Consommateur : vide la file en continu jusqu'à 200 ms sans message après la fin de l'envoi
+    std::atomic<bool> producerDone { false };
+    juce::WaitableEvent consumerDone;
+    LatencyHistogram latency;
+    int received = 0, outOfOrder = 0, maxFill = 0;
+
+    juce::Thread::launch ([&]
+    {
+        Event event;
+        int last = -1;
+        auto idleSince = juce::Time::getMillisecondCounterHiRes();
+
+        for (;;)
+        {
+            maxFill = juce::jmax (maxFill, queue.getNumReady());
+
+            if (queue.pop (event))
+            {
+                const auto now = juce::Time::getMillisecondCounterHiRes();
+                latency.recordMicroseconds ((uint64_t) juce::jmax (0.0, (now - event.timeMs) * 1000.0));
+
+                const int sequence = sequenceOf (event);
+                outOfOrder += sequence <= last ? 1 : 0;
+                last = sequence;
+                ++received;
+                idleSince = now;
+                continue;
+            }
+
+            if (producerDone.load() && juce::Time::getMillisecondCounterHiRes() - idleSince > 200.0)
+                break;
+
+            juce::Thread::yield();
+        }
+
+        consumerDone.signal();
+    });
+
+    // Producteur : boucle sur un port virtuel, le message arrive sur le thread du pilote
+    struct Loopback : public juce::MidiInputCallback
+    {
+        explicit Loopback (MidiEventQueue& q) : target (q) {}
+        void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& m) override   { target.push (m); }
+        MidiEventQueue& target;
+    };
+
+    Loopback loopback (queue);
+    std::unique_ptr<juce::MidiInput> input;
+    auto output = juce::MidiOutput::createNewDevice ("BIS MIDI Stress");
+
+    if (output != nullptr)
+        for (auto& device : juce::MidiInput::getAvailableDevices())
+            if (device.name == "BIS MIDI Stress")
+                input = juce::MidiInput::openDevice (device.identifier, &loopback);
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    if (input != nullptr)
+    {
+        input->start();
+
+        for (int i = 0; i < numEvents; ++i)
+            output->sendMessageNow (makeMessage (i));
+    }
+    else
+    {
+        for (int i = 0; i < numEvents; ++i)
+            queue.push (makeMessage (i));
+    }
+
+    const auto sendMs = juce::Time::getMillisecondCounterHiRes() - start;
+    producerDone = true;
+    consumerDone.wait();
+
+    if (input != nullptr)
+        input->stop();
+
+    const int dropped = queue.getAndResetNumDropped();
+
+    return "MIDI event queue stress (" + juce::String (input != nullptr ? "virtual port" : "direct push") + "): "
+         + juce::String (numEvents) + " sent in " + juce::String (sendMs, 0) + " ms ("
+         + juce::String (sendMs > 0.0 ? 1000.0 * numEvents / sendMs : 0.0, 0) + "/s), "
+         + juce::String (received) + " received, " + juce::String (dropped) + " dropped (queue full), "
+         + juce::String (numEvents - received - dropped) + " lost before the queue, "
+         + juce::String (outOfOrder) + " out of order, max fill " + juce::String (maxFill) + "/"
+         + juce::String (queue.getCapacity()) + "\n  " + latency.toString ("queue latency");
+}
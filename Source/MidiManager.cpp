@@ -14,8 +14,7 @@ MidiManager::~MidiManager()
         midiInput.reset();
     }
     
-    // Fermer la sortie MIDI
-    midiOutput.reset();
+    // La sortie MIDI est fermée par outputWorker, après l'envoi des messages en file
 }
 
 //==============================================================================
@@ -86,6 +85,15 @@ void MidiManager::initializeDevices()
 //==============================================================================
 void MidiManager::handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message)
 {
+    // Acquittement d'une bande par l'imprimante ; sans contrôle de flux, le CC
+    // reste un contrôleur ordinaire pour le spectacle
+    if (getPrinterFlowControl() && message.isController() && message.getChannel() == 15
+        && message.getControllerNumber() == printerAckController)
+    {
+        handlePrinterAck (message.getControllerValue());
+        return;
+    }
+    
     // Si un callback est défini, l'appeler
     if (onMidiMessageReceived)
     {
@@ -93,6 +101,20 @@ void MidiManager::handleIncomingMidiMessage (juce::MidiInput* source, const juce
     }
 }
 
+void MidiManager::handlePrinterAck (int band)
+{
+    const juce::ScopedLock sl (ackLock);
+    
+    if (printerAckCallback)
+        printerAckCallback (band);
+}
+
+void MidiManager::setPrinterAckCallback (std::function<void (int band)> callback)
+{
+    const juce::ScopedLock sl (ackLock);
+    printerAckCallback = std::move (callback);
+}
+
 //==============================================================================
 void MidiManager::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
 {
@@ -136,7 +158,7 @@ void MidiManager::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
     else if (comboBoxThatHasChanged == midiOutputComboBox)
     {
         // Fermer l'ancien périphérique
-        midiOutput.reset();
+        outputWorker.setOutput (nullptr);
         
         // Ouvrir le nouveau périphérique si sélectionné
         int selectedId = midiOutputComboBox->getSelectedId();
@@ -147,8 +169,9 @@ void MidiManager::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
             
             if (deviceIndex >= 0 && deviceIndex < devices.size())
             {
-                midiOutput = juce::MidiOutput::openDevice (devices[deviceIndex].identifier);
-                if (midiOutput != nullptr)
+                outputWorker.setOutput (juce::MidiOutput::openDevice (devices[deviceIndex].identifier));
+                
+                if (outputWorker.hasOutput())
                 {
                     if (enableLogging)
                     {
@@ -175,103 +198,79 @@ void MidiManager::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
 }
 
 //==============================================================================
+void MidiManager::setOutputMonitor (std::function<void (const juce::MidiMessage&)> newMonitor)
+{
+    outputWorker.setMonitor (std::move (newMonitor));
+}
+
+bool MidiManager::sendMessage (const juce::MidiMessage& message)
+{
+    outputWorker.send (message);
+    return outputWorker.hasOutput();
+}
+
+void MidiManager::scheduleMessage (const juce::MidiMessage& message, double millisecondCounterTime)
+{
+    outputWorker.sendAt (message, millisecondCounterTime);
+}
+
 void MidiManager::sendNoteOn (int channel, int noteNumber, uint8_t velocity, bool log)
 {
-    if (midiOutput != nullptr)
-    {
-        juce::MidiMessage message = juce::MidiMessage::noteOn (channel, noteNumber, velocity);
-        midiOutput->sendMessageNow (message);
-        
-        if (log && enableLogging)
-        {
-            juce::Logger::writeToLog ("MIDI OUT Note On - Channel: " + juce::String (channel) +
-                                       ", Note: " + juce::String (noteNumber) +
-                                       ", Velocity: " + juce::String (velocity));
-        }
-    }
+    juce::MidiMessage message = juce::MidiMessage::noteOn (channel, noteNumber, velocity);
+    
+    if (sendMessage (message) && log && enableLogging)
+        eventLog.addMidi (EventLog::Type::midiOut, message);
 }
 
 void MidiManager::sendNoteOff (int channel, int noteNumber, uint8_t velocity, bool log)
 {
-    if (midiOutput != nullptr)
-    {
-        juce::MidiMessage message = juce::MidiMessage::noteOff (channel, noteNumber, velocity);
-        midiOutput->sendMessageNow (message);
-        
-        if (log && enableLogging)
-        {
-            juce::Logger::writeToLog ("MIDI OUT Note Off - Channel: " + juce::String (channel) +
-                                       ", Note: " + juce::String (noteNumber) +
-                                       ", Velocity: " + juce::String (velocity));
-        }
-    }
+    juce::MidiMessage message = juce::MidiMessage::noteOff (channel, noteNumber, velocity);
+    
+    if (sendMessage (message) && log && enableLogging)
+        eventLog.addMidi (EventLog::Type::midiOut, message);
 }
 
 void MidiManager::sendProgramChange (int channel, int programNumber)
 {
-    if (midiOutput != nullptr)
-    {
-        juce::MidiMessage message = juce::MidiMessage::programChange (channel, programNumber);
-        midiOutput->sendMessageNow (message);
-        
-        if (enableLogging)
-        {
-            juce::Logger::writeToLog ("MIDI OUT Program Change - Channel: " + juce::String (channel) + 
-                                       ", Program: " + juce::String (programNumber));
-        }
-    }
+    juce::MidiMessage message = juce::MidiMessage::programChange (channel, programNumber);
+    
+    if (sendMessage (message) && enableLogging)
+        eventLog.addMidi (EventLog::Type::midiOut, message);
 }
 
 void MidiManager::sendControlChange (int channel, int controllerNumber, int controllerValue)
 {
-    if (midiOutput != nullptr)
+    juce::MidiMessage message = juce::MidiMessage::controllerEvent (channel, controllerNumber, controllerValue);
+    
+    if (sendMessage (message) && enableLogging)
+        eventLog.addMidi (EventLog::Type::midiOut, message);
+}
+
+bool MidiManager::sendPrinterMessage (const uint8_t* data, int size)
+{
+    // Chaque message attend son tour au débit du lien, au lieu d'un sleep(1) par octet
+    printerPacer.consume (size);
+    
+    // File d'envoi pleine : on attend qu'elle se vide plutôt que de perdre un
+    // octet, ce qui décalerait toute la bande
+    for (int attempt = 0; ! outputWorker.sendExternal (data, size); ++attempt)
     {
-        juce::MidiMessage message = juce::MidiMessage::controllerEvent (channel, controllerNumber, controllerValue);
-        midiOutput->sendMessageNow (message);
-        
-        if (enableLogging)
+        if (attempt >= printerQueueRetries)
         {
-            juce::Logger::writeToLog ("MIDI OUT Control Change - Channel: " + juce::String (channel) + 
-                                       ", CC: " + juce::String (controllerNumber) + 
-                                       ", Value: " + juce::String (controllerValue));
+            juce::Logger::writeToLog ("Printer message not sent: MIDI output queue full");
+            return false;
         }
+        
+        juce::Thread::sleep (1);
     }
+    
+    return true;
 }
 
-void MidiManager::sendByteAsMidiForPrinter (uint8_t b)
+void MidiManager::sendVisualNote (int channel, int noteNumber, uint8_t velocity)
 {
-    uint8_t note = b & 0x7F;
-    uint8_t vel  = (b & 0x80) ? 1 : 127;
-    //send midi on printer
-    sendNoteOn (15, note, vel, false);
-    
-    oct++;
-    
-    uint8_t noteForNotes = ((int)note + oct*12) % 60;
-    
-    if (oct > 5) {
-        oct = 0;
-    }
-    
-    bool* state = &allNotesState[noteForNotes];
-    *state = !*state;
-    
-    if(*state) {
-        lastNote = noteForNotes;
-    }
-    
-    sendNoteOn (1, (noteForNotes + MIN_NOTE), *state ? 127 : 0, false);
-    
-    uint8_t noteForLeds = ((int)note + oct*3) % 12;
-    
-    noteForLeds = noteForLeds + MIN_LED;
-    
-    sendNoteOn (10, lastLed, 0, false);
-    sendNoteOn (10, noteForLeds, 127, false);
-    
-    lastLed = noteForLeds;
-    
-    juce::Thread::sleep (1);
+    printerPacer.addExternalBytes (3);
+    sendNoteOn (channel, noteNumber, velocity, false);
 }
 
 //==============================================================================
@@ -340,9 +339,9 @@ void MidiManager::initializeMidiOutput()
         
         if (deviceIndex >= 0 && deviceIndex < midiDevices.size())
         {
-            midiOutput = juce::MidiOutput::openDevice (midiDevices[deviceIndex].identifier);
+            outputWorker.setOutput (juce::MidiOutput::openDevice (midiDevices[deviceIndex].identifier));
             
-            if (midiOutput != nullptr)
+            if (outputWorker.hasOutput())
             {
                 if (enableLogging)
                 {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MidiRatePacer.h"
+#include "MidiOutputWorker.h"
+#include "EventLog.h"
 
 #define MIN_NOTE 36
 #define MAX_NOTE 96
@@ -42,27 +45,86 @@ public:
     // ComboBox::Listener
     void comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged) override;
     
-    void sendByteAsMidiForPrinter(uint8_t b);
+    // Message pré-encodé de l'imprimante (PrintJobEncoder), cadencé au débit du lien, sans log.
+    // Les octets ne sont pas copiés : ils doivent rester valides jusqu'à waitForPrinterMessages().
+    // Renvoie false si le message n'a pas pu être mis en file (le travail doit être abandonné)
+    bool sendPrinterMessage (const uint8_t* data, int size);
+    // Renvoie false si des messages sont encore en file après timeoutMs
+    bool waitForPrinterMessages (int timeoutMs)         { return outputWorker.waitForExternalMessages (timeoutMs); }
+    
+    // Note des effets visuels (matrice, LEDs) pendant l'impression : elle ne bloque pas,
+    // mais ses octets sont décomptés du débit laissé aux données de l'imprimante
+    void sendVisualNote (int channel, int noteNumber, uint8_t velocity);
+    
+    // Transport des données de l'imprimante : une note par octet (d'origine) ou blocs SysEx
+    enum class PrinterTransport
+    {
+        notes,
+        sysex
+    };
+    
+    void setPrinterTransport (PrinterTransport transport)  { printerTransport = transport; }
+    PrinterTransport getPrinterTransport() const            { return printerTransport; }
+    
+    // Bandes vides (CC 61) et colonnes répétées (CC 62) : nécessite le firmware compatible
+    void setPrinterCompression (bool shouldCompress)        { printerCompression = shouldCompress; }
+    bool getPrinterCompression() const                      { return printerCompression; }
+    
+    // Contrôle de flux : le firmware acquitte chaque bande imprimée par un CC 70
+    // sur le canal 15 (valeur = numéro de la bande), reçu sur l'entrée MIDI
+    static constexpr int printerAckController = 70;
+    
+    void setPrinterFlowControl (bool shouldWaitForAck)      { printerFlowControl = shouldWaitForAck; }
+    bool getPrinterFlowControl() const                      { return printerFlowControl; }
+    
+    // Appelé depuis le thread MIDI à chaque acquittement. Avec le contrôle de
+    // flux, les acquittements ne sont pas transmis à onMidiMessageReceived ;
+    // sans, le CC 70 du canal 15 lui est transmis comme avant
+    void setPrinterAckCallback (std::function<void (int band)> callback);
+    
+    // Acquittement reçu hors de l'entrée MIDI (simulateur intégré, depuis le thread
+    // d'envoi) : va directement au callback, jamais à onMidiMessageReceived
+    void handlePrinterAck (int band);
+    
+    // Débit du flux de l'imprimante, en octets MIDI par seconde sur le fil
+    void setPrinterByteRate (double bytesPerSecond)     { printerPacer.setRate (bytesPerSecond); }
+    double getPrinterByteRate() const                   { return printerPacer.getRate(); }
+    void resetPrinterRateStats()                        { printerPacer.resetStats(); }
+    juce::String getPrinterRateReport() const           { return printerPacer.getReport(); }
     
     //==============================================================================
-    // Méthodes pour envoyer des messages MIDI
+    // Méthodes pour envoyer des messages MIDI : mis en file pour le thread d'envoi,
+    // elles n'attendent jamais le pilote
     void sendNoteOn (int channel, int noteNumber, uint8_t velocity, bool log = true);
     void sendNoteOff (int channel, int noteNumber, uint8_t velocity, bool log = true);
     void sendProgramChange (int channel, int programNumber);
     void sendControlChange (int channel, int controllerNumber, int controllerValue);
     
+    // Envoi programmé à une heure de Time::getMillisecondCounterHiRes() (repères
+    // lumineux calés sur la vidéo, par exemple)
+    void scheduleMessage (const juce::MidiMessage& message, double millisecondCounterTime);
+    
+    juce::String getOutputReport() const                { return outputWorker.getReport(); }
+    
+    // Journal des messages MIDI envoyés et reçus, mis en forme en tâche de fond
+    EventLog& getEventLog() noexcept                    { return eventLog; }
+    
+    // Reçoit une copie de chaque message au moment de son envoi, même sans sortie
+    // MIDI ouverte (simulateur d'imprimante), depuis le thread d'envoi
+    void setOutputMonitor (std::function<void (const juce::MidiMessage&)> newMonitor);
+    
     //==============================================================================
     // Callback pour les messages MIDI entrants (optionnel)
     std::function<void(juce::MidiInput*, const juce::MidiMessage&)> onMidiMessageReceived;
-public:
-    int lastNote = 0;
-    int lastLed = 0;
 private:
     //==============================================================================
     // Méthodes privées
     void initializeMidiInput();
     void initializeMidiOutput();
     
+    // Met le message en file ; renvoie false si aucune sortie n'est ouverte
+    bool sendMessage (const juce::MidiMessage& message);
+    
     //==============================================================================
     // Membres
     juce::ComboBox* midiInputComboBox = nullptr;
@@ -71,12 +133,23 @@ private:
     juce::Label* midiOutputLabel = nullptr;
     
     std::unique_ptr<juce::MidiInput> midiInput;
-    std::unique_ptr<juce::MidiOutput> midiOutput;
+    
+    // Propriétaire de la sortie MIDI, partagée par le thread message, la file
+    // d'impression et les effets
+    MidiOutputWorker outputWorker;
+    EventLog eventLog;
     
     bool enableLogging = true;
-
-    bool allNotesState[60];
-    int oct = 0;
+    
+    // Cadence les messages de sendPrinterMessage (thread d'impression)
+    MidiRatePacer printerPacer;
+    static constexpr int printerQueueRetries = 1000; // ~1 s de file pleine
+    std::atomic<PrinterTransport> printerTransport { PrinterTransport::notes };
+    std::atomic<bool> printerCompression { false };
+    std::atomic<bool> printerFlowControl { false };
+    
+    juce::CriticalSection ackLock;
+    std::function<void (int band)> printerAckCallback;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiManager)
 };
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    MidiOutputWorker.h
+    Thread d'envoi MIDI : propriétaire de la sortie, alimenté par une file
+    sans verrou à plusieurs producteurs, avec envoi immédiat ou programmé.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "MpscQueue.h"
+
+//==============================================================================
+/**
+    send() et sendAt() mettent le message en file et rendent la main : aucun
+    appelant n'attend le pilote MIDI. Le thread d'envoi réveillé vide la file,
+    range les messages programmés par heure (Time::getMillisecondCounterHiRes)
+    et envoie en un seul bloc tous ceux qui sont dus ; il se rendort jusqu'au
+    prochain message programmé, avec une attente active sur la dernière
+    milliseconde pour tomber à l'heure.
+
+    send() date le message de sa mise en file : il ne double pas un message
+    programmé déjà dû. Les messages partent par heure, et ceux de même heure
+    dans l'ordre d'arrivée. Le moniteur (simulateur d'imprimante) voit chaque
+    message juste après son envoi, même sans sortie ouverte, depuis le thread
+    d'envoi et hors de outputLock.
+
+    sendExternal() ne copie pas le message : seul un pointeur vers les octets
+    (tableau de PrintJobEncoder) passe par la file, et les octets sont recopiés
+    dans le bloc d'envoi, réservé d'avance. Un bloc SysEx ne coûte donc aucune
+    allocation, ni à l'appelant ni au thread d'envoi. L'appelant garde les octets
+    valides jusqu'au retour de waitForExternalMessages().
+*/
+class MidiOutputWorker : private juce::Thread
+{
+public:
+    MidiOutputWorker()
+        : juce::Thread ("MIDI output"), queue (queueCapacity)
+    {
+        scheduled.reserve (queueCapacity);
+        batch.ensureSize (batchCapacity);
+        startThread (juce::Thread::Priority::high);
+    }
+
+    // Les messages déjà dus sont envoyés avant l'arrêt, pas les messages programmés
+    ~MidiOutputWorker() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (2000);
+    }
+
+    //==============================================================================
+    // Renvoie false si la file est pleine (message perdu)
+    bool send (const juce::MidiMessage& message)
+    {
+        Pending pending { juce::Time::getMillisecondCounterHiRes(), 0, message };
+        pending.immediate = true;
+        return push (std::move (pending));
+    }
+
+    bool sendAt (const juce::MidiMessage& message, double millisecondCounterTime)
+    {
+        return push ({ millisecondCounterTime, 0, message });
+    }
+
+    // data doit rester valide jusqu'à l'envoi (waitForExternalMessages).
+    // Renvoie false si la file est pleine : rien n'est envoyé ni compté comme
+    // perdu, c'est à l'appelant de réessayer ou d'abandonner
+    bool sendExternal (const uint8_t* data, int size)
+    {
+        Pending pending;
+        pending.time = juce::Time::getMillisecondCounterHiRes();
+        pending.immediate = true;
+        pending.external = data;
+        pending.size = size;
+
+        ++numExternalPending;
+
+        if (! queue.push (std::move (pending)))
+        {
+            --numExternalPending;
+            return false;
+        }
+
+        notify();
+        return true;
+    }
+
+    // Attend que tous les messages de sendExternal() soient partis ; false après timeoutMs
+    bool waitForExternalMessages (int timeoutMs)
+    {
+        const auto end = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+
+        while (numExternalPending.load() > 0)
+        {
+            if (juce::Time::getMillisecondCounter() >= end)
+                return false;
+
+            juce::Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    void setOutput (std::unique_ptr<juce::MidiOutput> newOutput)
+    {
+        const juce::ScopedLock sl (outputLock);
+        output = std::move (newOutput);
+        outputOpen = output != nullptr;
+    }
+
+    bool hasOutput() const noexcept                 { return outputOpen.load(); }
+
+    using Monitor = std::function<void (const juce::MidiMessage&)>;
+
+    void setMonitor (Monitor newMonitor)
+    {
+        auto shared = newMonitor ? std::make_shared<const Monitor> (std::move (newMonitor)) : nullptr;
+
+        const juce::ScopedLock sl (outputLock);
+        monitor = std::move (shared);
+    }
+
+    juce::String getReport() const
+    {
+        return "MIDI output: " + juce::String ((juce::int64) numSent.load()) + " message(s) in "
+             + juce::String ((juce::int64) numBatches.load()) + " batch(es), "
+             + juce::String (numDropped.load()) + " dropped (queue full), scheduled max "
+             + juce::String (maxLateMs.load(), 2) + " ms late";
+    }
+
+private:
+    //==============================================================================
+    struct Pending
+    {
+        double time = 0.0;
+        uint64_t order = 0;
+        juce::MidiMessage message;
+        bool immediate = false; // send() : hors des mesures de retard
+
+        // Octets de sendExternal(), à la place de message
+        const uint8_t* external = nullptr;
+        int size = 0;
+
+        // Tas minimum sur (heure, ordre d'arrivée)
+        bool operator< (const Pending& other) const noexcept
+        {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
+    bool push (Pending&& pending)
+    {
+        if (! queue.push (std::move (pending)))
+        {
+            ++numDropped;
+            return false;
+        }
+
+        notify();
+        return true;
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            collectPending();
+            const double next = sendDueMessages();
+
+            if (next < 0.0)
+            {
+                wait (-1);
+                continue;
+            }
+
+            const double remaining = next - juce::Time::getMillisecondCounterHiRes();
+
+            if (remaining > 1.5)
+                wait ((int) remaining - 1);
+            else if (remaining > 0.0)
+                juce::Thread::yield();
+        }
+
+        collectPending();
+        sendDueMessages();
+    }
+
+    void collectPending()
+    {
+        Pending pending;
+
+        while (queue.pop (pending))
+        {
+            pending.order = nextOrder++;
+            scheduled.push_back (std::move (pending));
+            std::push_heap (scheduled.begin(), scheduled.end());
+        }
+    }
+
+    // Envoie les messages dus ; renvoie l'heure du prochain message programmé, ou -1
+    double sendDueMessages()
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        int count = 0, numExternal = 0;
+        batch.clear();
+
+        while (! scheduled.empty() && scheduled.front().time <= now)
+        {
+            std::pop_heap (scheduled.begin(), scheduled.end());
+            auto& pending = scheduled.back();
+
+            if (! pending.immediate)
+                maxLateMs = juce::jmax (maxLateMs.load(), now - pending.time);
+
+            if (pending.external != nullptr)
+            {
+                batch.addEvent (pending.external, pending.size, count++);
+                ++numExternal;
+            }
+            else
+            {
+                batch.addEvent (pending.message, count++);
+            }
+
+            scheduled.pop_back();
+        }
+
+        if (count > 0)
+        {
+            std::shared_ptr<const Monitor> currentMonitor;
+            {
+                const juce::ScopedLock sl (outputLock);
+
+                if (output != nullptr)
+                    output->sendBlockOfMessagesNow (batch);
+
+                currentMonitor = monitor;
+            }
+
+            // Hors du verrou : le moniteur (simulateur) prend ses propres verrous et
+            // répond à MidiManager ; lui seul reconstruit des MidiMessage
+            if (currentMonitor != nullptr)
+                for (const auto metadata : batch)
+                    (*currentMonitor) (metadata.getMessage());
+
+            numSent += (uint64_t) count;
+            numExternalPending -= numExternal;
+            ++numBatches;
+        }
+
+        return scheduled.empty() ? -1.0 : scheduled.front().time;
+    }
+
+    //==============================================================================
+    static constexpr int queueCapacity = 4096;
+    static constexpr int batchCapacity = 64 * 1024; // Un bloc plus gros agrandit le tampon une seule fois
+
+    MpscQueue<Pending> queue;
+
+    // Thread d'envoi uniquement
+    std::vector<Pending> scheduled;
+    juce::MidiBuffer batch;
+    uint64_t nextOrder = 0;
+
+    // Protège output et monitor le temps d'un envoi ou d'une copie : aucun
+    // appel extérieur (moniteur, callbacks) n'est fait sous ce verrou
+    juce::CriticalSection outputLock;
+    std::unique_ptr<juce::MidiOutput> output;
+    std::shared_ptr<const Monitor> monitor;
+    std::atomic<bool> outputOpen { false };
+
+    std::atomic<uint64_t> numSent { 0 }, numBatches { 0 };
+    std::atomic<int> numDropped { 0 };
+    std::atomic<int> numExternalPending { 0 };
+    std::atomic<double> maxLateMs { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiOutputWorker)
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    MidiRatePacer.h
+    Cadencement du flux MIDI de l'imprimante au débit du lien (seau à jetons).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/**
+    Seau à jetons en octets MIDI sur le fil : chaque message consomme sa taille
+    (3 octets pour une note), les jetons se rechargent à bytesPerSecond, et le
+    seau contient au plus burstBytes octets d'avance.
+
+    Un lien MIDI DIN à 31250 bauds transporte 3125 octets/s (10 bits par octet) :
+    le débit par défaut laisse un peu de marge.
+
+    consume() bloque le thread appelant jusqu'à l'heure d'envoi, en dormant
+    pour les longues attentes puis en attente active pour la dernière
+    milliseconde : la précision ne dépend plus de la granularité de sleep().
+    Un seul thread émetteur à la fois ; les autres threads qui partagent le lien
+    déclarent leurs octets avec addExternalBytes(), sans attendre.
+
+    Les statistiques (octets envoyés, temps actif) sont atomiques : le rapport
+    et la remise à zéro peuvent venir de n'importe quel thread. L'état du seau
+    reste au thread émetteur ; resetStats() lui demande seulement de repartir
+    d'une nouvelle période au prochain consume().
+*/
+class MidiRatePacer
+{
+public:
+    static constexpr double wireBytesPerSecond = 31250.0 / 10.0;
+
+    explicit MidiRatePacer (double bytesPerSecondToUse = 3000.0, int burstBytesToUse = 24)
+        : burstBytes (burstBytesToUse)
+    {
+        setRate (bytesPerSecondToUse);
+    }
+
+    void setRate (double newBytesPerSecond)     { bytesPerSecond = juce::jmax (100.0, newBytesPerSecond); }
+    double getRate() const noexcept             { return bytesPerSecond.load(); }
+
+    //==============================================================================
+    // Octets envoyés par un autre thread : décomptés au prochain consume()
+    void addExternalBytes (int numBytes) noexcept       { externalBytes.fetch_add (numBytes); }
+
+    // Attend que numBytes octets puissent partir, puis les décompte
+    void consume (int numBytes)
+    {
+        const double rate = bytesPerSecond.load();
+        auto now = juce::Time::getHighResolutionTicks();
+        const int external = externalBytes.exchange (0);
+
+        if (restartRequested.exchange (false))
+            lastTicks = 0;
+
+        // Après une pause (entre deux bandes), on repart avec un seau plein
+        // et la pause n'est pas comptée dans le débit mesuré
+        if (lastTicks == 0 || seconds (now - lastTicks) > idleGapSeconds)
+        {
+            tokens = (double) burstBytes;
+            segmentStartTicks = now;
+            activeSecondsBefore = activeSeconds.load();
+        }
+        else
+        {
+            tokens = juce::jmin ((double) burstBytes, tokens + seconds (now - lastTicks) * rate) - external;
+        }
+
+        // Les octets externes sont toujours sur le fil, même arrivés pendant une pause
+        bytesSent += (uint64_t) external;
+        lastTicks = now;
+
+        if (tokens < numBytes)
+        {
+            const double waitSeconds = ((double) numBytes - tokens) / rate;
+            const auto due = now + juce::Time::secondsToHighResolutionTicks (waitSeconds);
+
+            if (waitSeconds > 0.002)
+                juce::Thread::sleep ((int) (waitSeconds * 1000.0) - 1);
+
+            while ((now = juce::Time::getHighResolutionTicks()) < due)
+                juce::Thread::yield();
+
+            tokens += seconds (now - lastTicks) * rate;
+            lastTicks = now;
+        }
+
+        tokens -= numBytes;
+        bytesSent += (uint64_t) numBytes;
+        activeSeconds = activeSecondsBefore + seconds (lastTicks - segmentStartTicks);
+    }
+
+    //==============================================================================
+    void resetStats()
+    {
+        bytesSent = 0;
+        activeSeconds = 0.0;
+        restartRequested = true;
+    }
+
+    // Débit réel sur les périodes d'envoi, pauses exclues
+    double getAchievedRate() const noexcept
+    {
+        const double seconds = activeSeconds.load();
+        return seconds > 0.0 ? (double) bytesSent.load() / seconds : 0.0;
+    }
+
+    juce::String getReport() const
+    {
+        const double target = getRate();
+        const double achieved = getAchievedRate();
+
+        return "MIDI printer rate: " + juce::String (achieved, 0) + " B/s achieved, target "
+             + juce::String (target, 0) + " B/s (" + juce::String (target > 0.0 ? 100.0 * achieved / target : 0.0, 1)
+             + "%, wire " + juce::String (100.0 * achieved / wireBytesPerSecond, 1) + "%), "
+             + juce::String ((juce::int64) bytesSent.load()) + " bytes in " + juce::String (activeSeconds.load(), 2) + " s";
+    }
+
+private:
+    static double seconds (juce::int64 ticks) noexcept      { return juce::Time::highResolutionTicksToSeconds (ticks); }
+
+    static constexpr double idleGapSeconds = 0.05;
+
+    std::atomic<double> bytesPerSecond { 3000.0 };
+    std::atomic<int> externalBytes { 0 };
+    const int burstBytes;
+
+    // Statistiques, tous threads
+    std::atomic<uint64_t> bytesSent { 0 };
+    std::atomic<double> activeSeconds { 0.0 };
+    std::atomic<bool> restartRequested { false };
+
+    // Thread émetteur uniquement
+    double tokens = 0.0;
+    juce::int64 lastTicks = 0;
+    juce::int64 segmentStartTicks = 0;
+    double activeSecondsBefore = 0.0;
+};
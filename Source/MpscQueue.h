@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    MpscQueue.h
+    File bornée sans verrou, plusieurs producteurs et un consommateur.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    File bornée à plusieurs producteurs et un consommateur (tableau circulaire,
+    un numéro de séquence par case) : push() ne prend aucun verrou et échoue si
+    la file est pleine.
+*/
+template <typename Item>
+class MpscQueue
+{
+public:
+    explicit MpscQueue (int capacityPowerOfTwo)
+        : slots ((size_t) capacityPowerOfTwo), mask ((size_t) capacityPowerOfTwo - 1)
+    {
+        jassert (juce::isPowerOfTwo (capacityPowerOfTwo));
+
+        for (size_t i = 0; i < slots.size(); ++i)
+            slots[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    // N'importe quel thread
+    bool push (Item&& item) noexcept
+    {
+        auto position = enqueuePosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& slot = slots[position & mask];
+            const auto sequence = slot.sequence.load (std::memory_order_acquire);
+            const auto diff = (intptr_t) sequence - (intptr_t) position;
+
+            if (diff == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.item = std::move (item);
+                    slot.sequence.store (position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consommateur uniquement
+    bool pop (Item& item) noexcept
+    {
+        auto& slot = slots[dequeuePosition & mask];
+
+        if (slot.sequence.load (std::memory_order_acquire) != dequeuePosition + 1)
+            return false;
+
+        item = std::move (slot.item);
+        slot.sequence.store (dequeuePosition + mask + 1, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence { 0 };
+        Item item;
+    };
+
+    std::vector<Slot> slots;
+    const size_t mask;
+    std::atomic<size_t> enqueuePosition { 0 };
+    size_t dequeuePosition = 0;
+};
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    PhotoArchive.h
+    Archivage des photos en tâche de fond : un fichier PBM 1 bit numéroté par
+    photo, un index CSV, et l'export PNG optionnel.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include "PrintBitmap.h"
+
+//==============================================================================
+/**
+    add() copie la photo dans la file et rend la main tout de suite : toutes les
+    écritures disque se font sur le thread de l'archive.
+
+    Dans le dossier de l'archive :
+    - photo_000001.pbm, photo_000002.pbm... (PBM binaire "P4" : les lignes
+      compactées de PrintBitmap telles quelles, 1 = noir) ;
+    - index.csv : numéro, fichier, date, proportion de pixels noirs.
+
+    Avec un fichier PNG d'export, la dernière photo y est aussi écrite en PNG.
+
+    Les erreurs d'écriture sont signalées avec juce::Logger. Si le dossier ne
+    peut pas être créé, les photos ne sont pas archivées : l'erreur est signalée
+    une fois et l'ouverture n'est retentée qu'au bout de openRetryMs.
+*/
+class PhotoArchive : private juce::Thread
+{
+public:
+    PhotoArchive (const juce::File& directoryToUse, const juce::File& pngExportFileToUse = {})
+        : juce::Thread ("Photo archive"),
+          directory (directoryToUse),
+          pngExportFile (pngExportFileToUse)
+    {
+        startThread (juce::Thread::Priority::low);
+    }
+
+    // Les photos encore en file sont écrites avant de rendre la main
+    ~PhotoArchive() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (10000);
+    }
+
+    void add (const PrintBitmap& photo)
+    {
+        {
+            const juce::ScopedLock sl (queueLock);
+            queue.push_back ({ photo, juce::Time::getCurrentTime() });
+        }
+
+        notify();
+    }
+
+    const juce::File& getDirectory() const noexcept     { return directory; }
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        PrintBitmap photo;
+        juce::Time time;
+    };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (-1);
+            writePendingPhotos();
+        }
+
+        writePendingPhotos();
+    }
+
+    void writePendingPhotos()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                const juce::ScopedLock sl (queueLock);
+
+                if (queue.empty())
+                    return;
+
+                job = queue.front();
+                queue.pop_front();
+            }
+
+            writePhoto (job);
+        }
+    }
+
+    void writePhoto (const Job& job)
+    {
+        if (nextNumber == 0 && ! openArchive())
+            return;
+
+        const int number = nextNumber++;
+        auto name = "photo_" + juce::String (number).paddedLeft ('0', 6) + ".pbm";
+        auto file = directory.getChildFile (name);
+
+        int blackPixels = 0;
+        {
+            juce::FileOutputStream out (file);
+
+            if (! out.openedOk())
+            {
+                juce::Logger::writeToLog ("Photo archive: cannot write " + file.getFullPathName()
+                                          + " (" + out.getStatus().getErrorMessage() + ")");
+                return;
+            }
+
+            out.setPosition (0);
+            out.truncate();
+            out.writeText ("P4\n" + juce::String (PrintBitmap::width) + " " + juce::String (PrintBitmap::height) + "\n",
+                           false, false, nullptr);
+
+            for (int y = 0; y < PrintBitmap::height; ++y)
+            {
+                auto* row = job.photo.getRow (y);
+                out.write (row, PrintBitmap::bytesPerRow);
+
+                for (int i = 0; i < PrintBitmap::bytesPerRow; ++i)
+                    blackPixels += juce::countNumberOfBits ((juce::uint32) row[i]);
+            }
+
+            out.flush();
+
+            if (out.getStatus().failed())
+            {
+                juce::Logger::writeToLog ("Photo archive: error writing " + file.getFullPathName()
+                                          + " (" + out.getStatus().getErrorMessage() + ")");
+                return;
+            }
+        }
+
+        auto ink = (double) blackPixels / (double) (PrintBitmap::width * PrintBitmap::height);
+
+        if (! indexFile.appendText (juce::String (number) + "," + name + "," + job.time.toISO8601 (true) + ","
+                                    + juce::String (ink, 4) + "\n", false, false, "\n"))
+            juce::Logger::writeToLog ("Photo archive: cannot update " + indexFile.getFullPathName());
+
+        if (pngExportFile != juce::File() && ! writePng (job.photo))
+            juce::Logger::writeToLog ("Photo archive: cannot write " + pngExportFile.getFullPathName());
+
+        juce::Logger::writeToLog ("Photo archived: " + file.getFullPathName());
+    }
+
+    // Crée le dossier et l'index si besoin, et reprend la numérotation après la dernière photo
+    bool openArchive()
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+
+        if (openFailed && now - lastOpenAttemptMs < openRetryMs)
+            return false;
+
+        lastOpenAttemptMs = now;
+
+        if (! directory.createDirectory())
+        {
+            if (! openFailed)
+                juce::Logger::writeToLog ("Photo archive: cannot create " + directory.getFullPathName()
+                                          + ", photos are not archived");
+
+            openFailed = true;
+            return false;
+        }
+
+        if (openFailed)
+            juce::Logger::writeToLog ("Photo archive: " + directory.getFullPathName() + " is available again");
+
+        openFailed = false;
+        indexFile = directory.getChildFile ("index.csv");
+
+        if (! indexFile.existsAsFile() && ! indexFile.replaceWithText ("number,file,time,ink\n", false, false, "\n"))
+            juce::Logger::writeToLog ("Photo archive: cannot create " + indexFile.getFullPathName());
+
+        int last = 0;
+        for (auto& f : directory.findChildFiles (juce::File::findFiles, false, "photo_*.pbm"))
+            last = juce::jmax (last, f.getFileNameWithoutExtension().fromFirstOccurrenceOf ("_", false, false).getIntValue());
+
+        nextNumber = last + 1;
+        return true;
+    }
+
+    bool writePng (const PrintBitmap& photo)
+    {
+        juce::Image image (juce::Image::RGB, PrintBitmap::width, PrintBitmap::height, false);
+        {
+            juce::Image::BitmapData dst (image, juce::Image::BitmapData::writeOnly);
+
+            for (int y = 0; y < PrintBitmap::height; ++y)
+            {
+                auto* line = dst.getLinePointer (y);
+
+                for (int x = 0; x < PrintBitmap::width; ++x)
+                    std::memset (line + x * dst.pixelStride, photo.getPixel (x, y) ? 0x00 : 0xFF, (size_t) dst.pixelStride);
+            }
+        }
+
+        // Fichier temporaire puis remplacement : l'ancienne photo reste lisible jusqu'au bout
+        juce::TemporaryFile temp (pngExportFile);
+        {
+            juce::FileOutputStream stream (temp.getFile());
+            juce::PNGImageFormat png;
+
+            if (! stream.openedOk() || ! png.writeImageToStream (image, stream))
+                return false;
+        }
+
+        return temp.overwriteTargetFileWithTemporary();
+    }
+
+    //==============================================================================
+    const juce::File directory;
+    const juce::File pngExportFile;
+    juce::File indexFile;
+    static constexpr juce::uint32 openRetryMs = 60000;
+
+    // Thread de l'archive uniquement
+    int nextNumber = 0;
+    bool openFailed = false;
+    juce::uint32 lastOpenAttemptMs = 0;
+
+    juce::CriticalSection queueLock;
+    std::deque<Job> queue;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhotoArchive)
+};
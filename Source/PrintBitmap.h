@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    PrintBitmap.h
+    Photo 1 bit par pixel (320 x 180), stockée en lignes compactées, et
+    extraction des bandes de 24 points envoyées à l'imprimante.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+
+//==============================================================================
+/**
+    Chaque ligne de la photo est compactée sur 40 octets, bit de poids fort à
+    gauche (1 = noir).
+
+    L'imprimante reçoit 14 bandes de 192 colonnes x 3 octets. La colonne p d'une
+    bande correspond à la ligne 179 - p de la photo (les colonnes 180 à 191 sont
+    vides), et ses 3 octets couvrent les pixels 24 * bande à 24 * bande + 23 de
+    cette ligne, bit de poids fort en premier : ce sont donc directement les
+    octets 3 * bande à 3 * bande + 2 de la ligne compactée.
+*/
+class PrintBitmap
+{
+public:
+    static constexpr int width = 320;
+    static constexpr int height = 180;
+    static constexpr int bytesPerRow = width / 8;
+
+    static constexpr int numBands = 14;
+    static constexpr int bandColumns = 192;
+    static constexpr int bytesPerColumn = 3;
+    static constexpr int bytesPerBand = bandColumns * bytesPerColumn;
+
+    //==============================================================================
+    void clear() noexcept
+    {
+        std::memset (rows, 0, sizeof (rows));
+    }
+
+    // Compacte une ligne de tuiles (un octet par tuile, non nul = noir)
+    void setRow (int y, const uint8_t* ink, int numPixels) noexcept
+    {
+        if (y < 0 || y >= height)
+            return;
+
+        numPixels = juce::jmin (numPixels, width);
+        auto* row = rows[y];
+        std::memset (row, 0, bytesPerRow);
+
+        for (int x = 0; x < numPixels; ++x)
+            if (ink[x] != 0)
+                row[x >> 3] |= (uint8_t) (0x80 >> (x & 7));
+    }
+
+    bool getPixel (int x, int y) const noexcept
+    {
+        return (rows[y][x >> 3] & (0x80 >> (x & 7))) != 0;
+    }
+
+    const uint8_t* getRow (int y) const noexcept      { return rows[y]; }
+
+    //==============================================================================
+    // Remplit dest (bytesPerBand octets) dans l'ordre d'envoi à l'imprimante
+    void getBandBytes (int band, uint8_t* dest) const noexcept
+    {
+        const int firstByte = band * bytesPerColumn;
+
+        for (int column = 0; column < bandColumns; ++column)
+        {
+            auto* out = dest + column * bytesPerColumn;
+            const int y = height - 1 - column;
+
+            for (int b = 0; b < bytesPerColumn; ++b)
+                out[b] = (y >= 0 && firstByte + b < bytesPerRow) ? rows[y][firstByte + b] : 0;
+        }
+    }
+
+    // Vrai si la bande ne contient aucun point noir
+    bool isBandBlank (int band) const noexcept
+    {
+        const int firstByte = band * bytesPerColumn;
+        const int lastByte = juce::jmin (firstByte + bytesPerColumn, bytesPerRow);
+
+        for (int y = 0; y < height; ++y)
+            for (int b = firstByte; b < lastByte; ++b)
+                if (rows[y][b] != 0)
+                    return false;
+
+        return true;
+    }
+
+    // Inverse de getBandBytes() : les octets hors de la photo sont ignorés
+    void setBandBytes (int band, const uint8_t* src) noexcept
+    {
+        const int firstByte = band * bytesPerColumn;
+
+        for (int column = 0; column < bandColumns; ++column)
+        {
+            const auto* in = src + column * bytesPerColumn;
+            const int y = height - 1 - column;
+
+            for (int b = 0; b < bytesPerColumn; ++b)
+                if (y >= 0 && firstByte + b < bytesPerRow)
+                    rows[y][firstByte + b] = in[b];
+        }
+    }
+
+private:
+    uint8_t rows[height][bytesPerRow] = {};
+};
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    PrintBitmapTests.h
+    Tests de PrintBitmap : les bandes doivent être identiques, octet pour
+    octet, à celles de l'ancien encodeur (imgBufferForPrint).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "PrintBitmap.h"
+
+//==============================================================================
+class PrintBitmapTests : public juce::UnitTest
+{
+public:
+    PrintBitmapTests() : juce::UnitTest ("PrintBitmap", "BISPlayer") {}
+
+    // Photo sous forme de tuiles, un octet par pixel (non nul = noir)
+    using Tiles = std::vector<uint8_t>;
+
+    void runTest() override
+    {
+        beginTest ("All white");
+        checkAllBands (makeTiles ([] (int, int) { return false; }));
+
+        beginTest ("All black");
+        checkAllBands (makeTiles ([] (int, int) { return true; }));
+
+        beginTest ("Last band edge");
+        {
+            // Seuls les pixels 312 à 319 existent dans la dernière bande
+            const auto tiles = makeTiles ([] (int x, int y) { return x >= 312 && (x + y) % 3 != 0; });
+            checkAllBands (tiles);
+
+            uint8_t band[PrintBitmap::bytesPerBand];
+            toBitmap (tiles).getBandBytes (PrintBitmap::numBands - 1, band);
+
+            for (int column = 0; column < PrintBitmap::bandColumns; ++column)
+            {
+                expectEquals ((int) band[column * 3 + 1], 0, "bytes past x = 320 must be empty");
+                expectEquals ((int) band[column * 3 + 2], 0, "bytes past x = 320 must be empty");
+            }
+        }
+
+        beginTest ("Columns 180 to 191 are empty");
+        {
+            uint8_t band[PrintBitmap::bytesPerBand];
+            toBitmap (makeTiles ([] (int, int) { return true; })).getBandBytes (0, band);
+
+            for (int i = PrintBitmap::height * 3; i < PrintBitmap::bytesPerBand; ++i)
+                expectEquals ((int) band[i], 0);
+        }
+
+        beginTest ("Random photos");
+        {
+            auto random = getRandom();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const int density = random.nextInt (101);
+                checkAllBands (makeTiles ([&] (int, int) { return random.nextInt (100) < density; }));
+            }
+        }
+
+        beginTest ("setBandBytes is the inverse of getBandBytes");
+        {
+            auto random = getRandom();
+            const auto source = toBitmap (makeTiles ([&] (int, int) { return random.nextBool(); }));
+            PrintBitmap copy;
+            uint8_t band[PrintBitmap::bytesPerBand];
+
+            for (int b = 0; b < PrintBitmap::numBands; ++b)
+            {
+                source.getBandBytes (b, band);
+                copy.setBandBytes (b, band);
+            }
+
+            for (int y = 0; y < PrintBitmap::height; ++y)
+                expect (std::memcmp (copy.getRow (y), source.getRow (y), PrintBitmap::bytesPerRow) == 0);
+        }
+    }
+
+private:
+    //==============================================================================
+    template <typename Predicate>
+    static Tiles makeTiles (Predicate isBlack)
+    {
+        Tiles tiles ((size_t) (PrintBitmap::width * PrintBitmap::height));
+
+        for (int y = 0; y < PrintBitmap::height; ++y)
+            for (int x = 0; x < PrintBitmap::width; ++x)
+                tiles[(size_t) (y * PrintBitmap::width + x)] = isBlack (x, y) ? 1 : 0;
+
+        return tiles;
+    }
+
+    static PrintBitmap toBitmap (const Tiles& tiles)
+    {
+        PrintBitmap bitmap;
+
+        for (int y = 0; y < PrintBitmap::height; ++y)
+            bitmap.setRow (y, tiles.data() + y * PrintBitmap::width, PrintBitmap::width);
+
+        return bitmap;
+    }
+
+    // Ancien encodeur de CameraCapture : rotation dans imgBufferForPrint[192][320],
+    // puis compactage bit par bit de chaque colonne de 24 points
+    static void getReferenceBandBytes (const Tiles& tiles, int band, uint8_t* dest)
+    {
+        auto imgBuffer = [&] (int x, int y) { return tiles[(size_t) (y * PrintBitmap::width + x)] != 0; };
+
+        std::vector<std::vector<bool>> imgBufferForPrint (192, std::vector<bool> (320));
+
+        for (int x = 0; x < 320; x++)
+            for (int y = 0; y < 192; y++)
+                imgBufferForPrint[(size_t) y][(size_t) x] = y < 180 ? imgBuffer (x, 179 - y) : false;
+
+        const int maxLen = 320;
+        const int yBase = band * 24;
+        int n = 0;
+
+        for (int x = 0; x < 192; x++)
+        {
+            for (int byte = 0; byte < 3; byte++)
+            {
+                uint8_t v = 0;
+
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    const int y = yBase + byte * 8 + bit;
+
+                    if (y < maxLen && imgBufferForPrint[(size_t) x][(size_t) y])
+                        v |= (uint8_t) (1 << (7 - bit));
+                }
+
+                dest[n++] = v;
+            }
+        }
+    }
+
+    void checkAllBands (const Tiles& tiles)
+    {
+        const auto bitmap = toBitmap (tiles);
+        uint8_t band[PrintBitmap::bytesPerBand], reference[PrintBitmap::bytesPerBand];
+
+        for (int b = 0; b < PrintBitmap::numBands; ++b)
+        {
+            bitmap.getBandBytes (b, band);
+            getReferenceBandBytes (tiles, b, reference);
+
+            expect (std::memcmp (band, reference, sizeof (band)) == 0, "band " + juce::String (b) + " differs");
+
+            bool blank = true;
+            for (auto v : reference)
+                blank = blank && v == 0;
+
+            expectEquals (bitmap.isBandBlank (b), blank, "isBandBlank, band " + juce::String (b));
+        }
+    }
+};
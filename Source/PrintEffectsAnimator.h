@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    PrintEffectsAnimator.h
+    Effets lumineux pendant l'impression (matrice du canal 1, LEDs du canal 10),
+    rendus à cadence fixe à partir de l'avancement de l'impression.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "MidiManager.h"
+
+//==============================================================================
+/**
+    Auparavant chaque octet imprimé envoyait aussi une note de matrice et deux
+    notes de LEDs : les trois quarts du flux MIDI étaient décoratifs.
+
+    Ici, chaque image (30 par seconde) calcule l'état voulu :
+    - matrice (60 notes) : remplissage proportionnel à l'avancement, plus une
+      tête de lecture qui parcourt la partie restante ;
+    - LEDs (12 notes) : un chenillard.
+
+    Seules les notes qui changent d'état sont envoyées, soit quelques messages
+    par image. start(), setProgress() et stop() peuvent être appelés depuis le
+    thread d'impression ; stop() éteint tout ce qui est allumé.
+*/
+class PrintEffectsAnimator : private juce::HighResolutionTimer
+{
+public:
+    static constexpr int framesPerSecond = 30;
+    static constexpr int numMatrixNotes = 60;
+    static constexpr int numLeds = MAX_LED - MIN_LED;
+
+    explicit PrintEffectsAnimator (MidiManager* midiManagerToUse)
+        : midiManager (midiManagerToUse)
+    {
+    }
+
+    ~PrintEffectsAnimator() override
+    {
+        stop();
+    }
+
+    //==============================================================================
+    void start()
+    {
+        stopTimer();
+        progress = 0.f;
+        frame = 0;
+        messagesSent = 0;
+        startTimer (1000 / framesPerSecond);
+    }
+
+    void setProgress (float newProgress) noexcept       { progress = newProgress; }
+
+    void stop()
+    {
+        stopTimer();
+        bool off[numMatrixNotes + numLeds] = {};
+        sendDiffs (off);
+    }
+
+    juce::String getReport() const
+    {
+        return "Print effects: " + juce::String (frame) + " frame(s), " + juce::String (messagesSent) + " message(s)";
+    }
+
+private:
+    //==============================================================================
+    void hiResTimerCallback() override
+    {
+        bool target[numMatrixNotes + numLeds] = {};
+
+        const int filled = juce::jlimit (0, numMatrixNotes, juce::roundToInt (progress.load() * numMatrixNotes));
+
+        for (int i = 0; i < filled; ++i)
+            target[i] = true;
+
+        if (filled < numMatrixNotes)
+            target[filled + frame % (numMatrixNotes - filled)] = true;
+
+        // Le chenillard avance d'une LED toutes les deux images
+        target[numMatrixNotes + (frame / 2) % numLeds] = true;
+
+        sendDiffs (target);
+        ++frame;
+    }
+
+    void sendDiffs (const bool* target)
+    {
+        for (int i = 0; i < numMatrixNotes + numLeds; ++i)
+        {
+            if (target[i] == lit[i])
+                continue;
+
+            if (i < numMatrixNotes)
+                midiManager->sendVisualNote (1, MIN_NOTE + i, target[i] ? 127 : 0);
+            else
+                midiManager->sendVisualNote (10, MIN_LED + i - numMatrixNotes, target[i] ? 127 : 0);
+
+            lit[i] = target[i];
+            ++messagesSent;
+        }
+    }
+
+    //==============================================================================
+    MidiManager* midiManager;
+    std::atomic<float> progress { 0.f };
+
+    // Thread du timer, ou thread appelant quand le timer est arrêté
+    bool lit[numMatrixNotes + numLeds] = {};
+    int frame = 0;
+    int messagesSent = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrintEffectsAnimator)
+};
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    PrintJobEncoder.h
+    Encodage complet d'une photo en messages MIDI avant l'impression, avec
+    l'heure d'envoi prévue de chaque message.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "PrintBitmap.h"
+#include "PrinterSysEx.h"
+
+//==============================================================================
+/**
+    encode() écrit tous les messages de données de la photo, octets MIDI bout à
+    bout, dans un tableau d'octets réservé une fois pour toutes, avec pour
+    chaque message sa position, sa taille et son heure prévue. L'envoi ne fait
+    plus que passer des pointeurs vers ce tableau (MidiManager::sendPrinterMessage),
+    sans calcul, copie de message ni allocation, y compris pour les blocs SysEx.
+
+    Pour chaque bande :
+    - bande vide (avec la compression) : un CC 61 ;
+    - sinon : CC 60, données, CC 60. Les données sont une note par octet sur le
+      canal 15 (note = 7 bits de poids faible, vélocité 1 si le bit de poids
+      fort est à 1, 127 sinon), suivies d'un CC 62 pour les colonnes répétées
+      avec la compression, ou bien les blocs SysEx de PrinterSysEx.
+
+    L'heure de chaque message (Message::time) est son heure d'envoi prévue,
+    en millisecondes depuis le début de la bande, au débit donné : 4 ms après le
+    premier CC 60, puis chaque message après le précédent sur le fil, et 4 ms
+    avant le second CC 60.
+
+    Le début (PC 16/1) et la fin (CC 50) de la photo, les temps d'impression et
+    les effets lumineux restent à la charge de PrintSpooler.
+*/
+class PrintJobEncoder
+{
+public:
+    struct Band
+    {
+        int firstMessage = 0;
+        int endMessage = 0;
+        bool blank = false;
+    };
+
+    // Vue sur un message du tableau d'octets, valable jusqu'au prochain encode()
+    struct Message
+    {
+        const uint8_t* data = nullptr;
+        int size = 0;
+        double time = 0.0;
+    };
+
+    PrintJobEncoder()
+    {
+        // Pire cas : une note par octet, un CC 62 au plus toutes les deux colonnes
+        // et les deux CC 60 ; les blocs SysEx tiennent dans moins de place
+        constexpr int maxMessagesPerBand = PrintBitmap::bytesPerBand + PrintBitmap::bandColumns / 2 + 2;
+        static_assert (PrinterSysEx::chunksPerBand * PrinterSysEx::maxChunkSize + 6 <= maxMessagesPerBand * 3,
+                       "the SysEx transport must fit in the reserved bytes");
+
+        bytes.reserve ((size_t) (PrintBitmap::numBands * maxMessagesPerBand * 3));
+        entries.reserve ((size_t) (PrintBitmap::numBands * maxMessagesPerBand));
+    }
+
+    //==============================================================================
+    void encode (const PrintBitmap& photo, bool sysex, bool compress, double bytesPerSecond)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        bytes.clear();
+        entries.clear();
+        msPerByte = 1000.0 / juce::jmax (1.0, bytesPerSecond);
+        wireBytes = dataBytes = blankBands = repeatedColumns = 0;
+        uint8_t sequence = 0;
+        uint8_t bandBytes[PrintBitmap::bytesPerBand];
+
+        for (int b = 0; b < PrintBitmap::numBands; ++b)
+        {
+            auto& band = bands[b];
+            band.firstMessage = (int) entries.size();
+            band.blank = compress && photo.isBandBlank (b);
+            time = 0.0;
+
+            if (band.blank)
+            {
+                addShort (controller, 61, 61);
+                ++blankBands;
+            }
+            else
+            {
+                addShort (controller, 60, 60);
+                time += markerGapMs;
+
+                photo.getBandBytes (b, bandBytes);
+                dataBytes += PrintBitmap::bytesPerBand;
+
+                if (sysex)
+                    encodeSysEx (b, bandBytes, sequence);
+                else
+                    encodeNotes (bandBytes, compress);
+
+                time += markerGapMs;
+                addShort (controller, 60, 60);
+            }
+
+            band.endMessage = (int) entries.size();
+        }
+
+        encodeMs = 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+    }
+
+    //==============================================================================
+    const Band& getBand (int index) const noexcept  { return bands[index]; }
+
+    Message getMessage (int index) const noexcept
+    {
+        const auto& entry = entries[(size_t) index];
+        return { bytes.data() + entry.offset, entry.size, entry.time };
+    }
+
+    int getNumMessages() const noexcept             { return (int) entries.size(); }
+    int getBlankBands() const noexcept              { return blankBands; }
+    int getRepeatedColumns() const noexcept         { return repeatedColumns; }
+
+    juce::String getReport() const
+    {
+        return "Print job encoded: " + juce::String (getNumMessages()) + " messages, "
+             + juce::String (dataBytes) + " data bytes, " + juce::String (wireBytes) + " wire bytes in "
+             + juce::String (encodeMs, 2) + " ms";
+    }
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        int offset = 0;
+        int size = 0;
+        double time = 0.0;
+    };
+
+    // Canal 15
+    static constexpr uint8_t noteOn = 0x9E;
+    static constexpr uint8_t controller = 0xBE;
+
+    // Les size derniers octets de bytes forment le message suivant
+    void addEntry (int size)
+    {
+        entries.push_back ({ (int) bytes.size() - size, size, time });
+        time += size * msPerByte;
+        wireBytes += size;
+    }
+
+    void addShort (uint8_t status, uint8_t data1, uint8_t data2)
+    {
+        bytes.push_back (status);
+        bytes.push_back (data1);
+        bytes.push_back (data2);
+        addEntry (3);
+    }
+
+    void encodeNotes (const uint8_t* band, bool compress)
+    {
+        constexpr int columnBytes = PrintBitmap::bytesPerColumn;
+
+        for (int column = 0; column < PrintBitmap::bandColumns;)
+        {
+            const auto* current = band + column * columnBytes;
+
+            for (int i = 0; i < columnBytes; ++i)
+                addShort (noteOn, (uint8_t) (current[i] & 0x7F), (uint8_t) ((current[i] & 0x80) ? 1 : 127));
+
+            ++column;
+
+            if (compress)
+            {
+                int run = 0;
+                while (column + run < PrintBitmap::bandColumns && run < 127
+                        && std::memcmp (band + (column + run) * columnBytes, current, (size_t) columnBytes) == 0)
+                    ++run;
+
+                if (run > 0)
+                {
+                    addShort (controller, 62, (uint8_t) run);
+                    column += run;
+                    repeatedColumns += run;
+                }
+            }
+        }
+    }
+
+    // Chaque bloc est écrit directement à la fin du tableau (capacité réservée)
+    void encodeSysEx (int bandIndex, const uint8_t* band, uint8_t& sequence)
+    {
+        for (int c = 0; c < PrinterSysEx::chunksPerBand; ++c)
+        {
+            const auto offset = bytes.size();
+            bytes.resize (offset + PrinterSysEx::maxChunkSize);
+
+            const int size = PrinterSysEx::writeChunk (bytes.data() + offset, sequence++, bandIndex, c,
+                                                       band + c * PrinterSysEx::bytesPerChunk, PrinterSysEx::bytesPerChunk);
+            bytes.resize (offset + (size_t) size);
+            addEntry (size);
+        }
+    }
+
+    //==============================================================================
+    static constexpr double markerGapMs = 4.0;
+
+    std::vector<uint8_t> bytes;
+    std::vector<Entry> entries;
+    Band bands[PrintBitmap::numBands];
+
+    double msPerByte = 0.0;
+    double time = 0.0;
+    double encodeMs = 0.0;
+    int wireBytes = 0;
+    int dataBytes = 0;
+    int blankBands = 0;
+    int repeatedColumns = 0;
+};
@@ -0,0 +1,415 @@
+/*
+  ==============================================================================
+
+    PrintSpooler.h
+    File d'impression : les photos sont envoyées à l'imprimante MIDI par un
+    thread dédié, sans bloquer le thread message.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include "MidiManager.h"
+#include "PrintBitmap.h"
+#include "PrintEffectsAnimator.h"
+#include "PrintJobEncoder.h"
+
+//==============================================================================
+/**
+    submit() met une copie de la photo en file et rend la main tout de suite.
+    Le thread imprime les travaux un par un, avec le même protocole que l'ancien
+    CameraCapture::printPhoto() : 14 bandes séparées par une pause de 4 s. Chaque
+    photo est d'abord entièrement encodée (PrintJobEncoder), puis envoyée.
+
+    Avec la compression (MidiManager::setPrinterCompression) :
+    - une bande vide est remplacée par un CC 61 et une courte avance du papier ;
+    - les colonnes répétées sont envoyées une fois, suivies d'un CC 62 donnant
+      le nombre de répétitions.
+
+    Avec le contrôle de flux (MidiManager::setPrinterFlowControl), la bande
+    suivante part dès que l'imprimante a acquitté la précédente, au plus tard
+    après les 4 s habituelles si l'acquittement n'arrive pas.
+
+    Les effets lumineux sont rendus à part par PrintEffectsAnimator, à partir de
+    l'avancement du travail.
+
+    onProgress et onJobFinished sont appelés sur le thread message.
+    cancel() interrompt le travail en cours (entre deux octets ou pendant une
+    pause) et vide la file.
+*/
+class PrintSpooler : private juce::Thread,
+                     private juce::AsyncUpdater
+{
+public:
+    PrintSpooler (MidiManager* midiManagerToUse)
+        : juce::Thread ("Print spooler"), midiManager (midiManagerToUse), effects (midiManagerToUse)
+    {
+        midiManager->setPrinterAckCallback ([this] (int band)
+        {
+            lastAckedBand = band;
+            notify();
+        });
+
+        startThread (juce::Thread::Priority::high);
+    }
+
+    ~PrintSpooler() override
+    {
+        midiManager->setPrinterAckCallback (nullptr);
+        cancel();
+        stopThread (2000);
+        cancelPendingUpdate();
+    }
+
+    //==============================================================================
+    // Renvoie le numéro du travail
+    int submit (const PrintBitmap& photo)
+    {
+        int jobId;
+        {
+            const juce::ScopedLock sl (queueLock);
+            jobId = ++lastJobId;
+            queue.push_back ({ jobId, photo });
+        }
+
+        notify();
+        return jobId;
+    }
+
+    void cancel()
+    {
+        {
+            const juce::ScopedLock sl (queueLock);
+            cancelledJobs += (int) queue.size();
+            queue.clear();
+            cancelRequested = true;
+        }
+
+        notify();
+    }
+
+    bool isPrinting() const noexcept            { return currentJobId.load() != 0; }
+
+    int getNumPendingJobs() const
+    {
+        const juce::ScopedLock sl (queueLock);
+        return (int) queue.size();
+    }
+
+    // Avancement du travail en cours, de 0 à 1
+    float getProgress() const noexcept          { return progress.load(); }
+
+    //==============================================================================
+    std::function<void (int jobId, float progress)> onProgress;
+    std::function<void (int jobId, bool completed)> onJobFinished;
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        int id = 0;
+        PrintBitmap photo;
+    };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            Job job;
+            bool hasJob = false;
+            {
+                const juce::ScopedLock sl (queueLock);
+
+                if (! queue.empty())
+                {
+                    job = queue.front();
+                    queue.pop_front();
+                    hasJob = true;
+                    cancelRequested = false;
+                }
+            }
+
+            if (! hasJob)
+            {
+                wait (-1);
+                continue;
+            }
+
+            currentJobId = job.id;
+            setProgress (0.f);
+
+            auto& eventLog = midiManager->getEventLog();
+            eventLog.add (EventLog::Type::printStarted, 0,
+                          midiManager->getPrinterTransport() == MidiManager::PrinterTransport::sysex ? 1 : 0,
+                          midiManager->getPrinterCompression() ? 1 : 0, (float) job.id);
+
+            const bool completed = printJob (job.photo);
+
+            eventLog.add (EventLog::Type::printFinished, 0, completed ? 1 : 0, 0, (float) job.id);
+            currentJobId = 0;
+
+            {
+                const juce::ScopedLock sl (finishedLock);
+                finishedJobs.push_back ({ job.id, completed });
+            }
+
+            triggerAsyncUpdate();
+        }
+    }
+
+    // Renvoie false si l'impression a été annulée ou interrompue
+    bool printJob (const PrintBitmap& photo)
+    {
+        const bool sysex = midiManager->getPrinterTransport() == MidiManager::PrinterTransport::sysex;
+        const bool compress = midiManager->getPrinterCompression();
+        const bool flowControl = midiManager->getPrinterFlowControl();
+
+        // Toute la photo est encodée avant le premier envoi, jamais tant que la file
+        // d'envoi référence encore les octets du travail précédent
+        waitUntilPrinterMessagesSent();
+        encoder.encode (photo, sysex, compress, midiManager->getPrinterByteRate());
+
+        midiManager->resetPrinterRateStats();
+        midiManager->sendProgramChange (16, 1);
+        effects.start();
+
+        bool completed = true;
+        int ackedBands = 0, ackTimeouts = 0;
+        double ackWaitMs = 0.0, sendMs = 0.0, maxLateMs = 0.0;
+
+        for (int yy = 0; yy < PrintBitmap::numBands && completed; ++yy)
+        {
+            completed = pause (4);
+            if (! completed)
+                break;
+
+            const auto& band = encoder.getBand (yy);
+            lastAckedBand = -1;
+
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            completed = sendBand (yy, band, start, maxLateMs);
+            sendMs += juce::Time::getMillisecondCounterHiRes() - start;
+
+            setProgress ((float) (yy + 1) / (float) PrintBitmap::numBands);
+
+            if (! completed)
+                break;
+
+            // Bande vide : simple avance du papier, sans temps d'impression
+            if (band.blank)
+            {
+                completed = pause (blankBandFeedMs);
+                continue;
+            }
+
+            // Temps d'impression de la bande
+            if (flowControl)
+            {
+                const auto ackStart = juce::Time::getMillisecondCounterHiRes();
+                const auto ack = waitForBandAck (yy, bandPrintMs);
+
+                if (ack == AckResult::acked)
+                {
+                    ++ackedBands;
+                    ackWaitMs += juce::Time::getMillisecondCounterHiRes() - ackStart;
+                }
+
+                ackTimeouts += ack == AckResult::timedOut ? 1 : 0;
+                completed = ack != AckResult::cancelled;
+            }
+            else
+            {
+                completed = pause (bandPrintMs);
+            }
+        }
+
+        // Éteint aussi les notes laissées allumées par un travail interrompu
+        effects.stop();
+
+        // Le prochain encode() réécrira les octets encore référencés par la file d'envoi
+        if (! waitUntilPrinterMessagesSent())
+            completed = false;
+
+        midiManager->sendControlChange (15, 50, 50);
+        juce::Logger::writeToLog (encoder.getReport() + ", sent in " + juce::String (sendMs, 0)
+                                  + " ms (max " + juce::String (maxLateMs, 1) + " ms behind schedule)");
+        juce::Logger::writeToLog (midiManager->getPrinterRateReport());
+        juce::Logger::writeToLog (effects.getReport());
+
+        if (compress)
+            juce::Logger::writeToLog ("Print compression: " + juce::String (encoder.getBlankBands()) + " blank band(s) skipped, "
+                                      + juce::String (encoder.getRepeatedColumns()) + " repeated column(s)");
+
+        if (flowControl)
+            juce::Logger::writeToLog ("Print flow control: " + juce::String (ackedBands) + " band(s) acknowledged (mean "
+                                      + juce::String (ackedBands > 0 ? ackWaitMs / ackedBands : 0.0, 0) + " ms), "
+                                      + juce::String (ackTimeouts) + " timeout(s)");
+        return completed;
+    }
+
+    // Envoie les messages pré-encodés de la bande, pas avant leur heure prévue ;
+    // le débit reste limité par MidiManager (seau à jetons partagé avec les effets).
+    // Renvoie false si le travail est annulé ou si un message n'a pas pu partir
+    bool sendBand (int bandIndex, const PrintJobEncoder::Band& band, double startMs, double& maxLateMs)
+    {
+        const int numMessages = band.endMessage - band.firstMessage;
+
+        for (int i = band.firstMessage; i < band.endMessage; ++i)
+        {
+            const auto message = encoder.getMessage (i);
+            const double due = startMs + message.time;
+            const double now = juce::Time::getMillisecondCounterHiRes();
+
+            if (now < due - 1.0 && ! pause ((int) (due - now)))
+                return false;
+
+            maxLateMs = juce::jmax (maxLateMs, now - due);
+            if (! midiManager->sendPrinterMessage (message.data, message.size))
+                return false;
+
+            const int sent = i - band.firstMessage + 1;
+
+            if ((sent & 63) == 0)
+            {
+                if (shouldStop())
+                    return false;
+
+                setProgress (((float) bandIndex + (float) sent / (float) numMessages) / (float) PrintBitmap::numBands);
+            }
+        }
+
+        return ! shouldStop();
+    }
+
+    // Attend, sans limite, que la file d'envoi ne référence plus les octets de
+    // l'encodeur ; le thread d'envoi vide toujours sa file, même sans sortie.
+    // Renvoie false si l'attente a dépassé le délai habituel
+    bool waitUntilPrinterMessagesSent()
+    {
+        if (midiManager->waitForPrinterMessages (2000))
+            return true;
+
+        juce::Logger::writeToLog ("Print job: MIDI output is late, waiting for queued printer messages");
+
+        while (! midiManager->waitForPrinterMessages (1000))
+        {
+        }
+
+        return false;
+    }
+
+    bool shouldStop() const noexcept        { return threadShouldExit() || cancelRequested.load(); }
+
+    // Pause interrompue par cancel() ou l'arrêt du thread, mais pas par submit()
+    bool pause (int milliseconds)
+    {
+        const auto end = juce::Time::getMillisecondCounter() + (juce::uint32) milliseconds;
+
+        for (;;)
+        {
+            if (shouldStop())
+                return false;
+
+            const auto now = juce::Time::getMillisecondCounter();
+            if (now >= end)
+                return true;
+
+            wait ((int) (end - now));
+        }
+    }
+
+    enum class AckResult
+    {
+        acked,
+        timedOut,
+        cancelled
+    };
+
+    // Attend l'acquittement de la bande, réveillé par le callback de MidiManager
+    AckResult waitForBandAck (int band, int timeoutMs)
+    {
+        const auto end = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+
+        for (;;)
+        {
+            if (shouldStop())
+                return AckResult::cancelled;
+
+            if (lastAckedBand.load() == band)
+                return AckResult::acked;
+
+            const auto now = juce::Time::getMillisecondCounter();
+            if (now >= end)
+                return AckResult::timedOut;
+
+            wait ((int) (end - now));
+        }
+    }
+
+    void setProgress (float newProgress)
+    {
+        progress = newProgress;
+        effects.setProgress (newProgress);
+        triggerAsyncUpdate();
+    }
+
+    //==============================================================================
+    void handleAsyncUpdate() override
+    {
+        const int jobId = currentJobId.load();
+
+        if (jobId != 0 && onProgress)
+            onProgress (jobId, progress.load());
+
+        std::vector<std::pair<int, bool>> finished;
+        int cancelledInQueue = 0;
+        {
+            const juce::ScopedLock sl (finishedLock);
+            std::swap (finished, finishedJobs);
+        }
+        {
+            const juce::ScopedLock sl (queueLock);
+            std::swap (cancelledInQueue, cancelledJobs);
+        }
+
+        if (cancelledInQueue > 0)
+            juce::Logger::writeToLog ("Print spooler: " + juce::String (cancelledInQueue) + " queued job(s) cancelled");
+
+        for (auto& job : finished)
+        {
+            juce::Logger::writeToLog ("Print job " + juce::String (job.first) + (job.second ? " finished" : " cancelled"));
+
+            if (onJobFinished)
+                onJobFinished (job.first, job.second);
+        }
+    }
+
+    //==============================================================================
+    MidiManager* midiManager;
+    PrintEffectsAnimator effects;
+    PrintJobEncoder encoder; // thread d'impression uniquement
+
+    juce::CriticalSection queueLock;
+    std::deque<Job> queue;
+    int lastJobId = 0;
+    int cancelledJobs = 0;
+
+    juce::CriticalSection finishedLock;
+    std::vector<std::pair<int, bool>> finishedJobs;
+
+    std::atomic<int> currentJobId { 0 };
+    std::atomic<float> progress { 0.f };
+    std::atomic<bool> cancelRequested { false };
+    std::atomic<int> lastAckedBand { -1 };
+
+    // Temps d'impression d'une bande, ou délai maximal d'attente de l'acquittement
+    static constexpr int bandPrintMs = 4000;
+
+    // Avance du papier pour une bande vide, au lieu des 4 s d'impression
+    static constexpr int blankBandFeedMs = 300;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrintSpooler)
+};
@@ -0,0 +1,364 @@
+/*
+  ==============================================================================
+
+    PrinterSimulator.h
+    Imprimante MIDI simulée : décode le flux envoyé à l'imprimante, reconstruit
+    la photo imprimée et mesure le débit et le temps de chaque bande.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "PrintBitmap.h"
+#include "PrinterSysEx.h"
+
+//==============================================================================
+/**
+    Reçoit les messages soit directement de MidiManager (setOutputMonitor, sans
+    périphérique MIDI), soit par le port virtuel "BIS Printer Simulator"
+    (openVirtualPort, à choisir comme sortie MIDI), et suit le protocole de
+    PrintSpooler :
+
+    - PC 1 sur le canal 16 : début d'une photo ;
+    - CC 60 sur le canal 15 : début puis fin d'une bande ;
+    - notes du canal 15 : un octet par note (note = 7 bits de poids faible,
+      vélocité 1 = bit de poids fort à 1, 127 = à 0) ;
+    - CC 61 : bande vide, CC 62 n : n répétitions de la colonne précédente ;
+    - SysEx 7D 42 : blocs de bande, décodés par PrinterSysEx::Decoder ;
+    - CC 50 : fin de la photo, rapport dans le log et export PNG.
+
+    Comme le firmware avec contrôle de flux (setAcknowledgeBands, désactivé par
+    défaut), chaque bande reçue est acquittée par un CC 70 sur le canal 15 : vers
+    onReply en mode intégré, ou par la sortie virtuelle "BIS Printer Simulator"
+    (à choisir comme entrée MIDI). Sans contrôle de flux, rien n'est renvoyé.
+
+    Le débit "données" compte les octets de la photo, le débit "fil" tous les
+    octets MIDI envoyés pendant les bandes, CC 60 d'ouverture et de fermeture
+    et notes visuelles compris.
+
+    En fin de photo, process() copie la photo et les mesures et rend la main :
+    le rapport et l'export PNG sont faits sur un thread à part, sans retenir le
+    thread émetteur (en mode intégré, le thread de sortie MIDI).
+*/
+class PrinterSimulator : private juce::MidiInputCallback
+{
+public:
+    explicit PrinterSimulator (const juce::File& pngExportFileToUse = {})
+        : pngExportFile (pngExportFileToUse)
+    {
+        photo.clear();
+    }
+
+    ~PrinterSimulator() override
+    {
+        if (device != nullptr)
+            device->stop();
+    }
+
+    // Réponses de l'imprimante en mode intégré (acquittements), depuis le thread émetteur
+    std::function<void (const juce::MidiMessage&)> onReply;
+
+    // Acquittement des bandes, à activer seulement si l'émetteur les attend
+    void setAcknowledgeBands (bool shouldAcknowledge)  { acknowledgeBands = shouldAcknowledge; }
+
+    // Port MIDI virtuel (macOS / Linux) ; renvoie false s'il n'a pas pu être créé
+    bool openVirtualPort()
+    {
+        device = juce::MidiInput::createNewDevice ("BIS Printer Simulator", this);
+
+        if (device == nullptr)
+        {
+            juce::Logger::writeToLog ("Virtual MIDI devices are not supported on this platform");
+            return false;
+        }
+
+        device->start();
+        replyDevice = juce::MidiOutput::createNewDevice ("BIS Printer Simulator");
+        return true;
+    }
+
+    //==============================================================================
+    // Point d'entrée du flux, depuis n'importe quel thread
+    void process (const juce::MidiMessage& message)
+    {
+        const juce::ScopedLock sl (lock);
+        const auto now = juce::Time::getHighResolutionTicks();
+
+        if (inBand)
+            bandWireBytes += message.getRawDataSize();
+
+        if (message.isSysEx())
+        {
+            processSysEx (message);
+            return;
+        }
+
+        const int channel = message.getChannel();
+
+        if (message.isProgramChange() && channel == 16 && message.getProgramChangeNumber() == 1)
+        {
+            startPhoto (now);
+        }
+        else if (message.isNoteOn() && channel == 15 && inBand)
+        {
+            const auto note = (uint8_t) message.getNoteNumber();
+            addByte ((uint8_t) (note | (message.getVelocity() == 1 ? 0x80 : 0x00)));
+        }
+        else if (message.isController() && channel == 15)
+        {
+            switch (message.getControllerNumber())
+            {
+                case 60:    inBand ? endBand (now) : startBand (now); break;
+                case 61:    ++blankBands; ++bandIndex; break;
+                case 62:    repeatLastColumn (message.getControllerValue()); break;
+                case 50:    endPhoto (now); break;
+                default:    break;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Dernière photo reconstruite (copie, sous verrou)
+    PrintBitmap getPhoto() const
+    {
+        const juce::ScopedLock sl (lock);
+        return photo;
+    }
+
+    juce::Image getImage() const        { return createImage (getPhoto()); }
+
+    juce::String getReport() const
+    {
+        const juce::ScopedLock sl (lock);
+        return report;
+    }
+
+private:
+    //==============================================================================
+    struct BandTiming
+    {
+        int band = 0;
+        int dataBytes = 0;
+        int wireBytes = 0;
+        double milliseconds = 0.0;
+    };
+
+    // Copie de fin de photo, traitée hors du thread émetteur
+    struct PhotoSummary
+    {
+        PrintBitmap photo;
+        juce::Array<BandTiming> bands;
+        int blankBands = 0;
+        int protocolErrors = 0;
+        double seconds = 0.0;
+    };
+
+    void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& message) override
+    {
+        process (message);
+    }
+
+    void startPhoto (juce::int64 now)
+    {
+        photo.clear();
+        decoder.reset();
+        bands.clearQuick();
+        photoStartTicks = now;
+        bandIndex = blankBands = protocolErrors = 0;
+        inBand = false;
+    }
+
+    void startBand (juce::int64 now)
+    {
+        std::memset (bandBytes, 0, sizeof (bandBytes));
+        bytePosition = 0;
+        bandDataBytes = 0;
+        bandWireBytes = 3; // CC 60 d'ouverture, reçu avant inBand
+        bandStartTicks = now;
+        inBand = true;
+    }
+
+    void endBand (juce::int64 now)
+    {
+        inBand = false;
+
+        // En SysEx la bande est déjà dans la photo : seules les notes passent par bandBytes
+        if (bytePosition > 0 && bandIndex < PrintBitmap::numBands)
+            photo.setBandBytes (bandIndex, bandBytes);
+
+        if (bytePosition > 0 && bytePosition != PrintBitmap::bytesPerBand)
+            ++protocolErrors;
+
+        bands.add ({ bandIndex, bandDataBytes, bandWireBytes,
+                     1000.0 * juce::Time::highResolutionTicksToSeconds (now - bandStartTicks) });
+
+        if (acknowledgeBands)
+            reply (juce::MidiMessage::controllerEvent (15, 70, bandIndex & 0x7F));
+        ++bandIndex;
+    }
+
+    void reply (const juce::MidiMessage& message)
+    {
+        if (replyDevice != nullptr)
+            replyDevice->sendMessageNow (message);
+
+        if (onReply)
+            onReply (message);
+    }
+
+    void addByte (uint8_t b)
+    {
+        if (bytePosition >= PrintBitmap::bytesPerBand)
+        {
+            ++protocolErrors;
+            return;
+        }
+
+        bandBytes[bytePosition++] = b;
+        ++bandDataBytes;
+    }
+
+    void repeatLastColumn (int count)
+    {
+        constexpr int columnBytes = PrintBitmap::bytesPerColumn;
+
+        if (! inBand || bytePosition < columnBytes || bytePosition % columnBytes != 0)
+        {
+            ++protocolErrors;
+            return;
+        }
+
+        for (int i = 0; i < count && bytePosition < PrintBitmap::bytesPerBand; ++i)
+        {
+            std::memcpy (bandBytes + bytePosition, bandBytes + bytePosition - columnBytes, (size_t) columnBytes);
+            bytePosition += columnBytes;
+        }
+    }
+
+    void processSysEx (const juce::MidiMessage& message)
+    {
+        const auto result = decoder.process (message, photo);
+
+        if (result == PrinterSysEx::Decoder::Result::ok || result == PrinterSysEx::Decoder::Result::sequenceGap)
+            bandDataBytes += PrinterSysEx::getDecodedSize (message.getSysExDataSize() - PrinterSysEx::headerSize - 1);
+
+        if (result != PrinterSysEx::Decoder::Result::ok && result != PrinterSysEx::Decoder::Result::notPrinterData)
+            ++protocolErrors;
+    }
+
+    void endPhoto (juce::int64 now)
+    {
+        inBand = false;
+
+        auto summary = std::make_shared<PhotoSummary>();
+        summary->photo = photo;
+        summary->bands = bands;
+        summary->blankBands = blankBands;
+        summary->protocolErrors = protocolErrors;
+        summary->seconds = juce::Time::highResolutionTicksToSeconds (now - photoStartTicks);
+
+        exportPool.addJob ([this, summary] { reportPhoto (*summary); });
+    }
+
+    // Thread d'export : rapport dans le log, puis PNG
+    void reportPhoto (const PhotoSummary& summary)
+    {
+        int dataBytes = 0, wireBytes = 0, blackPixels = 0;
+        double bandMs = 0.0, maxBandMs = 0.0;
+
+        for (auto& b : summary.bands)
+        {
+            dataBytes += b.dataBytes;
+            wireBytes += b.wireBytes;
+            bandMs += b.milliseconds;
+            maxBandMs = juce::jmax (maxBandMs, b.milliseconds);
+        }
+
+        for (int y = 0; y < PrintBitmap::height; ++y)
+            for (int i = 0; i < PrintBitmap::bytesPerRow; ++i)
+                blackPixels += juce::countNumberOfBits ((juce::uint32) summary.photo.getRow (y)[i]);
+
+        auto perSecond = [] (int bytes, double ms) { return juce::String (ms > 0.0 ? 1000.0 * bytes / ms : 0.0, 0); };
+
+        juce::String text = "Printer simulator - " + juce::String (summary.bands.size()) + " band(s), " + juce::String (summary.blankBands) + " blank, "
+                          + juce::String (dataBytes) + " data bytes (" + perSecond (dataBytes, bandMs) + " B/s), "
+                          + juce::String (wireBytes) + " wire bytes (" + perSecond (wireBytes, bandMs) + " B/s), band mean "
+                          + juce::String (summary.bands.isEmpty() ? 0.0 : bandMs / summary.bands.size(), 1) + " ms, max " + juce::String (maxBandMs, 1)
+                          + " ms, photo " + juce::String (summary.seconds, 2)
+                          + " s, ink " + juce::String ((double) blackPixels / (double) (PrintBitmap::width * PrintBitmap::height), 4)
+                          + ", errors " + juce::String (summary.protocolErrors);
+
+        for (auto& b : summary.bands)
+            text << "\n  band " << b.band << ": " << b.dataBytes << " B in " << juce::String (b.milliseconds, 1)
+                 << " ms (" << perSecond (b.dataBytes, b.milliseconds) << " B/s)";
+
+        juce::Logger::writeToLog (text);
+
+        {
+            const juce::ScopedLock sl (lock);
+            report = text;
+        }
+
+        if (pngExportFile != juce::File())
+        {
+            juce::FileOutputStream stream (pngExportFile);
+            juce::PNGImageFormat png;
+
+            if (stream.openedOk())
+            {
+                stream.setPosition (0);
+                stream.truncate();
+                png.writeImageToStream (createImage (summary.photo), stream);
+            }
+        }
+    }
+
+    static juce::Image createImage (const PrintBitmap& bitmap)
+    {
+        juce::Image image (juce::Image::RGB, PrintBitmap::width, PrintBitmap::height, false);
+        {
+            juce::Image::BitmapData dst (image, juce::Image::BitmapData::writeOnly);
+
+            for (int y = 0; y < PrintBitmap::height; ++y)
+            {
+                auto* line = dst.getLinePointer (y);
+
+                for (int x = 0; x < PrintBitmap::width; ++x)
+                    std::memset (line + x * dst.pixelStride, bitmap.getPixel (x, y) ? 0x00 : 0xFF, (size_t) dst.pixelStride);
+            }
+        }
+
+        return image;
+    }
+
+    //==============================================================================
+    const juce::File pngExportFile;
+    std::unique_ptr<juce::MidiInput> device;
+    std::unique_ptr<juce::MidiOutput> replyDevice;
+
+    juce::CriticalSection lock;
+    PrintBitmap photo;
+    PrinterSysEx::Decoder decoder;
+    juce::Array<BandTiming> bands;
+    juce::String report;
+
+    uint8_t bandBytes[PrintBitmap::bytesPerBand];
+    int bytePosition = 0;
+    int bandIndex = 0;
+    int bandDataBytes = 0;
+    int bandWireBytes = 0;
+    int blankBands = 0;
+    int protocolErrors = 0;
+    bool inBand = false;
+    std::atomic<bool> acknowledgeBands { false };
+    juce::int64 photoStartTicks = 0;
+    juce::int64 bandStartTicks = 0;
+
+    // Dernier membre : arrêté en premier, avant que les données ne disparaissent
+    juce::ThreadPool exportPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrinterSimulator)
+};
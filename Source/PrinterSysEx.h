@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    PrinterSysEx.h
+    Transport SysEx des données de l'imprimante : encodage 8 -> 7 bits,
+    numéros de séquence et somme de contrôle, et décodeur de référence.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PrintBitmap.h"
+
+//==============================================================================
+/**
+    Une bande (576 octets) part en 3 blocs de 192 octets (64 colonnes) :
+
+        F0 7D 42 01 <seq> <bande> <bloc> <données encodées...> <somme> F7
+
+    - 7D : identifiant fabricant réservé aux usages non commerciaux, 42 ('B') : BIS ;
+    - 01 : type "données de bande" ;
+    - seq : numéro du bloc modulo 128, remis à 0 au début de chaque photo ;
+    - données : groupes de 7 octets encodés sur 8, le premier octet du groupe
+      portant les bits de poids fort (bit i = poids fort de l'octet i) ;
+    - somme : XOR de tous les octets depuis le type, sur 7 bits.
+
+    Soit 229 octets sur le fil par bloc, 687 par bande, contre 1728 pour les
+    notes du canal 15 (6912 avec les notes visuelles par octet d'origine).
+*/
+namespace PrinterSysEx
+{
+    static constexpr uint8_t manufacturerId = 0x7D;
+    static constexpr uint8_t deviceId = 0x42;
+    static constexpr uint8_t bandDataType = 0x01;
+
+    static constexpr int chunksPerBand = 3;
+    static constexpr int bytesPerChunk = PrintBitmap::bytesPerBand / chunksPerBand;
+    static constexpr int headerSize = 6; // 7D 42 type seq bande bloc
+
+    constexpr int getEncodedSize (int numBytes)     { return numBytes + (numBytes + 6) / 7; }
+
+    constexpr int getDecodedSize (int numEncoded)
+    {
+        const int remainder = numEncoded % 8;
+        return (numEncoded / 8) * 7 + (remainder > 0 ? remainder - 1 : 0);
+    }
+
+    // Taille d'un bloc complet sur le fil, F0 et F7 compris
+    static constexpr int maxChunkSize = 1 + headerSize + getEncodedSize (bytesPerChunk) + 1 + 1;
+
+    //==============================================================================
+    // Écrit le message complet (F0 ... F7) dans dest (maxChunkSize octets au
+    // moins), sans allocation ; renvoie sa taille
+    inline int writeChunk (uint8_t* dest, uint8_t sequence, int band, int chunk, const uint8_t* data, int numBytes)
+    {
+        jassert (numBytes <= bytesPerChunk);
+
+        int n = 0;
+        dest[n++] = 0xF0;
+        dest[n++] = manufacturerId;
+        dest[n++] = deviceId;
+        dest[n++] = bandDataType;
+        dest[n++] = (uint8_t) (sequence & 0x7F);
+        dest[n++] = (uint8_t) band;
+        dest[n++] = (uint8_t) chunk;
+
+        for (int i = 0; i < numBytes; i += 7)
+        {
+            const int groupSize = juce::jmin (7, numBytes - i);
+            auto& highBits = dest[n++];
+            highBits = 0;
+
+            for (int j = 0; j < groupSize; ++j)
+            {
+                highBits |= (uint8_t) ((data[i + j] >> 7) << j);
+                dest[n++] = (uint8_t) (data[i + j] & 0x7F);
+            }
+        }
+
+        uint8_t checksum = 0;
+        for (int i = 3; i < n; ++i)
+            checksum ^= dest[i];
+
+        dest[n++] = (uint8_t) (checksum & 0x7F);
+        dest[n++] = 0xF7;
+        return n;
+    }
+
+    inline juce::MidiMessage encodeChunk (uint8_t sequence, int band, int chunk, const uint8_t* data, int numBytes)
+    {
+        uint8_t buffer[maxChunkSize];
+        return juce::MidiMessage (buffer, writeChunk (buffer, sequence, band, chunk, data, numBytes));
+    }
+
+    //==============================================================================
+    /**
+        Décodeur de référence : reconstruit les bandes de la photo à partir des
+        blocs reçus, et compte les erreurs de format, de somme et de séquence.
+    */
+    class Decoder
+    {
+    public:
+        enum class Result
+        {
+            notPrinterData,
+            ok,
+            badFormat,
+            badChecksum,
+            sequenceGap
+        };
+
+        // Les octets d'un bloc accepté (même après un trou de séquence) sont écrits dans photo
+        Result process (const juce::MidiMessage& message, PrintBitmap& photo)
+        {
+            if (! message.isSysEx())
+                return Result::notPrinterData;
+
+            const auto* data = message.getSysExData();
+            const int size = message.getSysExDataSize();
+
+            if (size < 2 || data[0] != manufacturerId || data[1] != deviceId)
+                return Result::notPrinterData;
+
+            if (size < headerSize + 1 || data[2] != bandDataType)
+                return count (Result::badFormat);
+
+            uint8_t checksum = 0;
+            for (int i = 2; i < size - 1; ++i)
+                checksum ^= data[i];
+
+            if ((checksum & 0x7F) != data[size - 1])
+                return count (Result::badChecksum);
+
+            const int sequence = data[3];
+            const int band = data[4];
+            const int chunk = data[5];
+            const int numEncoded = size - headerSize - 1;
+            const int numBytes = getDecodedSize (numEncoded);
+
+            if (band >= PrintBitmap::numBands || chunk >= chunksPerBand || numBytes > bytesPerChunk)
+                return count (Result::badFormat);
+
+            // Début d'une photo : la séquence repart de zéro
+            const bool newPhoto = band == 0 && chunk == 0;
+            const bool gap = ! newPhoto && expectedSequence >= 0 && sequence != expectedSequence;
+            expectedSequence = (sequence + 1) & 0x7F;
+
+            if (newPhoto)
+                photo.clear();
+
+            uint8_t bandBytes[PrintBitmap::bytesPerBand];
+            photo.getBandBytes (band, bandBytes);
+
+            auto* dest = bandBytes + chunk * bytesPerChunk;
+            const auto* encoded = data + headerSize;
+
+            for (int i = 0, e = 0; i < numBytes; i += 7)
+            {
+                const uint8_t highBits = encoded[e++];
+                const int groupSize = juce::jmin (7, numBytes - i);
+
+                for (int j = 0; j < groupSize; ++j)
+                    dest[i + j] = (uint8_t) (encoded[e++] | (((highBits >> j) & 1) << 7));
+            }
+
+            photo.setBandBytes (band, bandBytes);
+            bytesDecoded += numBytes;
+
+            return count (gap ? Result::sequenceGap : Result::ok);
+        }
+
+        void reset()
+        {
+            expectedSequence = -1;
+            chunksOk = checksumErrors = formatErrors = sequenceGaps = 0;
+            bytesDecoded = 0;
+        }
+
+        juce::String getReport() const
+        {
+            return "SysEx decoder - chunks: " + juce::String (chunksOk)
+                 + ", bytes: " + juce::String (bytesDecoded)
+                 + ", checksum errors: " + juce::String (checksumErrors)
+                 + ", format errors: " + juce::String (formatErrors)
+                 + ", sequence gaps: " + juce::String (sequenceGaps);
+        }
+
+    private:
+        Result count (Result result)
+        {
+            switch (result)
+            {
+                case Result::ok:            ++chunksOk; break;
+                case Result::sequenceGap:   ++chunksOk; ++sequenceGaps; break;
+                case Result::badChecksum:   ++checksumErrors; break;
+                case Result::badFormat:     ++formatErrors; break;
+                case Result::notPrinterData:
+                default:                    break;
+            }
+
+            return result;
+        }
+
+        int expectedSequence = -1;
+        int chunksOk = 0, checksumErrors = 0, formatErrors = 0, sequenceGaps = 0;
+        int bytesDecoded = 0;
+    };
+}
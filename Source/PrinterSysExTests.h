@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    PrinterSysExTests.h
+    Tests du transport SysEx de l'imprimante : aller-retour encodeur ->
+    décodeur, sommes de contrôle corrompues et blocs hors séquence.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "PrinterSysEx.h"
+
+//==============================================================================
+class PrinterSysExTests : public juce::UnitTest
+{
+public:
+    PrinterSysExTests() : juce::UnitTest ("PrinterSysEx", "BISPlayer") {}
+
+    void runTest() override
+    {
+        using Result = PrinterSysEx::Decoder::Result;
+
+        beginTest ("Encoded sizes");
+        {
+            for (int n = 1; n <= PrinterSysEx::bytesPerChunk; ++n)
+                expectEquals (PrinterSysEx::getDecodedSize (PrinterSysEx::getEncodedSize (n)), n);
+
+            uint8_t data[PrinterSysEx::bytesPerChunk] = {};
+            const auto message = PrinterSysEx::encodeChunk (0, 0, 0, data, PrinterSysEx::bytesPerChunk);
+            expectEquals (message.getRawDataSize(), 229);
+        }
+
+        beginTest ("Random photos round trip");
+        {
+            auto random = getRandom();
+
+            for (int i = 0; i < 10; ++i)
+            {
+                const auto photo = makeRandomPhoto (random);
+                const auto messages = encodePhoto (photo);
+
+                PrinterSysEx::Decoder decoder;
+                PrintBitmap decoded;
+
+                for (auto& message : messages)
+                {
+                    expect (isSevenBitClean (message), "SysEx data must be 7-bit");
+                    expect (decoder.process (message, decoded) == Result::ok);
+                }
+
+                expect (samePhoto (photo, decoded), "decoded photo differs");
+            }
+        }
+
+        beginTest ("Extreme bytes");
+        {
+            PrintBitmap photo;
+            std::vector<uint8_t> row ((size_t) PrintBitmap::width, 1);
+
+            // Alterne lignes noires et blanches : octets 0xFF et 0x00
+            for (int y = 0; y < PrintBitmap::height; y += 2)
+                photo.setRow (y, row.data(), PrintBitmap::width);
+
+            PrinterSysEx::Decoder decoder;
+            PrintBitmap decoded;
+
+            for (auto& message : encodePhoto (photo))
+                expect (decoder.process (message, decoded) == Result::ok);
+
+            expect (samePhoto (photo, decoded));
+        }
+
+        beginTest ("Corrupted checksum");
+        {
+            auto random = getRandom();
+            const auto photo = makeRandomPhoto (random);
+            auto messages = encodePhoto (photo);
+
+            PrinterSysEx::Decoder decoder;
+            PrintBitmap decoded;
+
+            // Un octet de données modifié dans le bloc 4 : la somme ne correspond plus
+            const int corrupted = 4;
+            messages[(size_t) corrupted] = modify (messages[(size_t) corrupted], PrinterSysEx::headerSize + 10,
+                                                   [] (uint8_t b) { return (uint8_t) (b ^ 0x01); });
+
+            // Somme elle-même modifiée dans le bloc 7
+            const int badSum = 7;
+            messages[(size_t) badSum] = modify (messages[(size_t) badSum], messages[(size_t) badSum].getSysExDataSize() - 1,
+                                                [] (uint8_t b) { return (uint8_t) ((b + 1) & 0x7F); });
+
+            for (int i = 0; i < (int) messages.size(); ++i)
+            {
+                const auto result = decoder.process (messages[(size_t) i], decoded);
+
+                if (i == corrupted || i == badSum)
+                    expect (result == Result::badChecksum, "chunk " + juce::String (i) + " should fail its checksum");
+                else if (i == corrupted + 1 || i == badSum + 1)
+                    expect (result == Result::sequenceGap, "a rejected chunk leaves a sequence gap");
+                else
+                    expect (result == Result::ok);
+            }
+
+            // Les bandes des blocs rejetés restent vides, les autres sont intactes
+            expect (! samePhoto (photo, decoded));
+            expect (sameBand (photo, decoded, 0));
+            expect (sameBand (photo, decoded, 4));
+        }
+
+        beginTest ("Out of sequence chunks");
+        {
+            auto random = getRandom();
+            const auto photo = makeRandomPhoto (random);
+            auto messages = encodePhoto (photo);
+
+            // Deux blocs échangés au milieu de la photo
+            std::swap (messages[10], messages[11]);
+
+            PrinterSysEx::Decoder decoder;
+            PrintBitmap decoded;
+            int gaps = 0;
+
+            for (auto& message : messages)
+            {
+                const auto result = decoder.process (message, decoded);
+                expect (result == Result::ok || result == Result::sequenceGap);
+                gaps += result == Result::sequenceGap ? 1 : 0;
+            }
+
+            // Les données portent leur bande et leur bloc : la photo est complète malgré tout
+            expectEquals (gaps, 3);
+            expect (samePhoto (photo, decoded));
+        }
+
+        beginTest ("Other messages");
+        {
+            PrinterSysEx::Decoder decoder;
+            PrintBitmap decoded;
+
+            expect (decoder.process (juce::MidiMessage::noteOn (15, 60, (juce::uint8) 127), decoded) == Result::notPrinterData);
+
+            const uint8_t otherMaker[] = { 0x43, 0x10, 0x01 };
+            expect (decoder.process (juce::MidiMessage::createSysExMessage (otherMaker, 3), decoded) == Result::notPrinterData);
+
+            const uint8_t wrongType[] = { PrinterSysEx::manufacturerId, PrinterSysEx::deviceId, 0x05, 0, 0, 0, 0x05 };
+            expect (decoder.process (juce::MidiMessage::createSysExMessage (wrongType, 7), decoded) == Result::badFormat);
+
+            const uint8_t badBand[] = { PrinterSysEx::manufacturerId, PrinterSysEx::deviceId, PrinterSysEx::bandDataType,
+                                        0, 20, 0, 0x00, 0x01, (uint8_t) (PrinterSysEx::bandDataType ^ 20 ^ 0x01) };
+            expect (decoder.process (juce::MidiMessage::createSysExMessage (badBand, 9), decoded) == Result::badFormat);
+        }
+    }
+
+private:
+    //==============================================================================
+    static PrintBitmap makeRandomPhoto (juce::Random& random)
+    {
+        PrintBitmap photo;
+        std::vector<uint8_t> row ((size_t) PrintBitmap::width);
+        const int density = 10 + random.nextInt (81); // Jamais vide ni plein
+
+        for (int y = 0; y < PrintBitmap::height; ++y)
+        {
+            for (auto& tile : row)
+                tile = random.nextInt (100) < density ? 1 : 0;
+
+            photo.setRow (y, row.data(), PrintBitmap::width);
+        }
+
+        return photo;
+    }
+
+    // Même découpage que PrintJobEncoder : séquence remise à zéro pour la photo
+    static std::vector<juce::MidiMessage> encodePhoto (const PrintBitmap& photo)
+    {
+        std::vector<juce::MidiMessage> messages;
+        uint8_t band[PrintBitmap::bytesPerBand];
+        uint8_t sequence = 0;
+
+        for (int b = 0; b < PrintBitmap::numBands; ++b)
+        {
+            photo.getBandBytes (b, band);
+
+            for (int chunk = 0; chunk < PrinterSysEx::chunksPerBand; ++chunk)
+                messages.push_back (PrinterSysEx::encodeChunk (sequence++, b, chunk, band + chunk * PrinterSysEx::bytesPerChunk,
+                                                               PrinterSysEx::bytesPerChunk));
+        }
+
+        return messages;
+    }
+
+    template <typename Function>
+    static juce::MidiMessage modify (const juce::MidiMessage& message, int index, Function change)
+    {
+        std::vector<uint8_t> data (message.getSysExData(), message.getSysExData() + message.getSysExDataSize());
+        data[(size_t) index] = change (data[(size_t) index]);
+        return juce::MidiMessage::createSysExMessage (data.data(), (int) data.size());
+    }
+
+    static bool isSevenBitClean (const juce::MidiMessage& message)
+    {
+        for (int i = 0; i < message.getSysExDataSize(); ++i)
+            if (message.getSysExData()[i] >= 0x80)
+                return false;
+
+        return true;
+    }
+
+    static bool sameBand (const PrintBitmap& a, const PrintBitmap& b, int band)
+    {
+        uint8_t bytesA[PrintBitmap::bytesPerBand], bytesB[PrintBitmap::bytesPerBand];
+        a.getBandBytes (band, bytesA);
+        b.getBandBytes (band, bytesB);
+        return std::memcmp (bytesA, bytesB, sizeof (bytesA)) == 0;
+    }
+
+    static bool samePhoto (const PrintBitmap& a, const PrintBitmap& b)
+    {
+        for (int y = 0; y < PrintBitmap::height; ++y)
+            if (std::memcmp (a.getRow (y), b.getRow (y), PrintBitmap::bytesPerRow) != 0)
+                return false;
+
+        return true;
+    }
+};
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    Quantizer.h
+    Quantification 1 bit de la grille de tuiles : seuil simple, diffusion
+    d'erreur (Floyd-Steinberg, Atkinson) et tramage ordonné de Bayer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <memory>
+
+//==============================================================================
+/**
+    Transforme une grille de niveaux de gris (un octet par tuile) en encre :
+    ink[i] = 1 pour une tuile noire, 0 pour une tuile blanche.
+    Une instance n'est utilisée que par un seul thread à la fois.
+*/
+class Quantizer
+{
+public:
+    enum class Mode
+    {
+        threshold = 0,
+        floydSteinberg,
+        atkinson,
+        bayer
+    };
+
+    virtual ~Quantizer() = default;
+
+    virtual void process (const uint8_t* grey, int width, int height, int threshold, uint8_t* ink) = 0;
+
+    // Ne requantifie que les lignes [firstRow, endRow) et renvoie les lignes réellement
+    // écrites : les quantificateurs à diffusion d'erreur dépendent des lignes
+    // précédentes et refont toute la grille.
+    virtual juce::Range<int> processRows (const uint8_t* grey, int width, int height, int firstRow, int endRow,
+                                          int threshold, uint8_t* ink)
+    {
+        juce::ignoreUnused (firstRow, endRow);
+        process (grey, width, height, threshold, ink);
+        return { 0, height };
+    }
+
+    static std::unique_ptr<Quantizer> create (Mode mode);
+    static juce::StringArray getModeNames()
+    {
+        return { "Threshold", "Floyd-Steinberg", "Atkinson", "Bayer 8x8" };
+    }
+
+    static juce::String runBenchmark (int width = 320, int height = 180, int iterations = 500);
+};
+
+//==============================================================================
+// Seuil fixe par tuile (comportement d'origine)
+class ThresholdQuantizer : public Quantizer
+{
+public:
+    void process (const uint8_t* grey, int width, int height, int threshold, uint8_t* ink) override
+    {
+        processRows (grey, width, height, 0, height, threshold, ink);
+    }
+
+    juce::Range<int> processRows (const uint8_t* grey, int width, int, int firstRow, int endRow,
+                                  int threshold, uint8_t* ink) override
+    {
+        for (int i = firstRow * width; i < endRow * width; ++i)
+            ink[i] = grey[i] < threshold ? 1 : 0;
+
+        return { firstRow, endRow };
+    }
+};
+
+//==============================================================================
+// Tramage ordonné avec une matrice de Bayer 8x8
+class BayerQuantizer : public Quantizer
+{
+public:
+    void process (const uint8_t* grey, int width, int height, int threshold, uint8_t* ink) override
+    {
+        processRows (grey, width, height, 0, height, threshold, ink);
+    }
+
+    juce::Range<int> processRows (const uint8_t* grey, int width, int, int firstRow, int endRow,
+                                  int threshold, uint8_t* ink) override
+    {
+        static constexpr uint8_t bayer[8][8] =
+        {
+            {  0, 32,  8, 40,  2, 34, 10, 42 },
+            { 48, 16, 56, 24, 50, 18, 58, 26 },
+            { 12, 44,  4, 36, 14, 46,  6, 38 },
+            { 60, 28, 52, 20, 62, 30, 54, 22 },
+            {  3, 35, 11, 43,  1, 33,  9, 41 },
+            { 51, 19, 59, 27, 49, 17, 57, 25 },
+            { 15, 47,  7, 39, 13, 45,  5, 37 },
+            { 63, 31, 55, 23, 61, 29, 53, 21 }
+        };
+
+        // Seuils par position, calculés une fois par frame : threshold +/- 126
+        int16_t levels[8][8];
+        for (int y = 0; y < 8; ++y)
+            for (int x = 0; x < 8; ++x)
+                levels[y][x] = (int16_t) (threshold + bayer[y][x] * 4 + 2 - 128);
+
+        for (int y = firstRow; y < endRow; ++y)
+        {
+            const auto* row = levels[y & 7];
+            const auto* in = grey + y * width;
+            auto* out = ink + y * width;
+
+            for (int x = 0; x < width; ++x)
+                out[x] = in[x] < row[x & 7] ? 1 : 0;
+        }
+
+        return { firstRow, endRow };
+    }
+};
+
+//==============================================================================
+// Diffusion d'erreur de Floyd-Steinberg, en entiers sur deux lignes d'erreur
+class FloydSteinbergQuantizer : public Quantizer
+{
+public:
+    void process (const uint8_t* grey, int width, int height, int threshold, uint8_t* ink) override
+    {
+        // Une case de marge de chaque côté pour éviter les tests de bord
+        current.assign ((size_t) width + 2, 0);
+        next.assign ((size_t) width + 2, 0);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const auto* in = grey + y * width;
+            auto* out = ink + y * width;
+            auto* err = current.data() + 1;
+            auto* below = next.data() + 1;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const int value = in[x] + (err[x] >> 4);
+                const bool black = value < threshold;
+                const int e = value - (black ? 0 : 255);
+
+                out[x] = black ? 1 : 0;
+                err[x + 1]   += e * 7;
+                below[x - 1] += e * 3;
+                below[x]     += e * 5;
+                below[x + 1] += e;
+            }
+
+            std::swap (current, next);
+            std::fill (next.begin(), next.end(), 0);
+        }
+    }
+
+private:
+    std::vector<int32_t> current, next; // erreurs en 1/16
+};
+
+//==============================================================================
+// Diffusion d'erreur d'Atkinson (6/8 de l'erreur, sur trois lignes)
+class AtkinsonQuantizer : public Quantizer
+{
+public:
+    void process (const uint8_t* grey, int width, int height, int threshold, uint8_t* ink) override
+    {
+        for (auto& r : rows)
+            r.assign ((size_t) width + 3, 0);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const auto* in = grey + y * width;
+            auto* out = ink + y * width;
+            auto* err = rows[0].data() + 1;
+            auto* below = rows[1].data() + 1;
+            auto* below2 = rows[2].data() + 1;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const int value = in[x] + err[x];
+                const bool black = value < threshold;
+                const int e = (value - (black ? 0 : 255)) >> 3;
+
+                out[x] = black ? 1 : 0;
+                err[x + 1]   += e;
+                err[x + 2]   += e;
+                below[x - 1] += e;
+                below[x]     += e;
+                below[x + 1] += e;
+                below2[x]    += e;
+            }
+
+            std::rotate (std::begin (rows), std::begin (rows) + 1, std::end (rows));
+            std::fill (rows[2].begin(), rows[2].end(), 0);
+        }
+    }
+
+private:
+    std::vector<int32_t> rows[3];
+};
+
+//==============================================================================
+inline std::unique_ptr<Quantizer> Quantizer::create (Mode mode)
+{
+    switch (mode)
+    {
+        case Mode::floydSteinberg:  return std::make_unique<FloydSteinbergQuantizer>();
+        case Mode::atkinson:        return std::make_unique<AtkinsonQuantizer>();
+        case Mode::bayer:           return std::make_unique<BayerQuantizer>();
+        case Mode::threshold:
+        default:                    return std::make_unique<ThresholdQuantizer>();
+    }
+}
+
+// Débit de chaque quantificateur sur une grille de tuiles synthétique
+inline juce::String Quantizer::runBenchmark (int width, int height, int iterations)
+{
+    juce::String report ("Quantizer benchmark (" + juce::String (width) + "x" + juce::String (height) + " tiles)");
+
+    std::vector<uint8_t> grey ((size_t) (width * height)), ink (grey.size());
+    juce::Random rng (1234);
+
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            grey[(size_t) (y * width + x)] = (uint8_t) juce::jlimit (0, 255, x * 255 / width + rng.nextInt (17) - 8);
+
+    auto names = getModeNames();
+
+    for (int m = 0; m < names.size(); ++m)
+    {
+        auto quantizer = create ((Mode) m);
+        quantizer->process (grey.data(), width, height, 127, ink.data()); // préchauffage
+
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        for (int i = 0; i < iterations; ++i)
+            quantizer->process (grey.data(), width, height, 127, ink.data());
+        auto ms = (juce::Time::getMillisecondCounterHiRes() - start) / iterations;
+
+        report << "\n  " << names[m] << ": " << juce::String (ms * 1000.0, 1) << " us/frame, "
+               << juce::String ((double) (width * height) / (ms * 1000.0), 1) << " Mtiles/s";
+    }
+
+    return report;
+}
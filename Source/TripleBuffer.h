@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Triple buffer sans verrou entre un producteur et un consommateur.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+
+//==============================================================================
+/**
+    Le producteur écrit toujours dans son propre buffer puis le publie ; le
+    consommateur récupère la dernière frame publiée sans jamais bloquer.
+    Un seul thread producteur et un seul thread consommateur.
+*/
+template <typename FrameType>
+class TripleBuffer
+{
+public:
+    //==============================================================================
+    // Côté producteur
+    FrameType& getWriteBuffer() noexcept          { return buffers[writeIndex]; }
+
+    // Publie le buffer d'écriture. Renvoie false si la frame publiée
+    // précédemment n'a jamais été lue (elle est alors perdue).
+    bool publish() noexcept
+    {
+        auto previous = shared.exchange (writeIndex | freshFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+        return (previous & freshFlag) == 0;
+    }
+
+    //==============================================================================
+    // Côté consommateur : renvoie true si une nouvelle frame est disponible
+    bool acquire() noexcept
+    {
+        if ((shared.load (std::memory_order_acquire) & freshFlag) == 0)
+            return false;
+
+        auto previous = shared.exchange (readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const FrameType& getReadBuffer() const noexcept { return buffers[readIndex]; }
+
+private:
+    //==============================================================================
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+
+    FrameType buffers[3];
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> shared { 2 };
+};